@@ -0,0 +1,245 @@
+/* advanced/hal/meow_hal_atomic.h - Atomic Operations and Memory Barriers
+ *
+ * The few atomic read-modify-write operations and barriers the lock
+ * library is built from. They are inline assembly rather than HAL ops:
+ * a function pointer call per lock operation would cost more than the
+ * operation itself.
+ *
+ * Every read-modify-write is a full barrier on both architectures.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#ifndef MEOW_HAL_ATOMIC_H
+#define MEOW_HAL_ATOMIC_H
+
+#include <stdint.h>
+
+/* ============================================================================
+ * ATOMIC TYPES
+ * ============================================================================ */
+
+typedef struct meow_atomic {
+    volatile uint32_t value;
+} meow_atomic_t;
+
+#define MEOW_ATOMIC_INIT(v)     { (v) }
+
+/* ============================================================================
+ * BARRIERS
+ * ============================================================================ */
+
+/* Keep the compiler from moving memory accesses across this point */
+static inline void meow_barrier(void) {
+    asm volatile("" ::: "memory");
+}
+
+#if defined(__i386__)
+
+/* x86 only reorders stores after later loads, so only the full barrier
+ * needs an instruction; a locked add works on CPUs without SSE2 */
+static inline void meow_mb(void) {
+    asm volatile("lock; addl $0, 0(%%esp)" ::: "memory", "cc");
+}
+
+static inline void meow_rmb(void) {
+    meow_barrier();
+}
+
+static inline void meow_wmb(void) {
+    meow_barrier();
+}
+
+static inline void meow_cpu_relax(void) {
+    asm volatile("pause" ::: "memory");
+}
+
+#elif defined(__aarch64__)
+
+static inline void meow_mb(void) {
+    asm volatile("dmb ish" ::: "memory");
+}
+
+static inline void meow_rmb(void) {
+    asm volatile("dmb ishld" ::: "memory");
+}
+
+static inline void meow_wmb(void) {
+    asm volatile("dmb ishst" ::: "memory");
+}
+
+static inline void meow_cpu_relax(void) {
+    asm volatile("yield" ::: "memory");
+}
+
+#else
+#error "meow_hal_atomic.h: no atomics for this architecture"
+#endif
+
+/* ============================================================================
+ * READ-MODIFY-WRITE
+ * ============================================================================ */
+
+#if defined(__i386__)
+
+static inline uint32_t meow_atomic_xchg_u32(volatile uint32_t* ptr, uint32_t value) {
+    /* xchg with memory is always locked */
+    asm volatile("xchgl %0, %1" : "+r"(value), "+m"(*ptr) :: "memory");
+    return value;
+}
+
+/* Returns the old value; the swap happened if it equals @expected */
+static inline uint32_t meow_atomic_cmpxchg_u32(volatile uint32_t* ptr, uint32_t expected,
+                                               uint32_t desired) {
+    uint32_t previous;
+    asm volatile("lock; cmpxchgl %2, %1"
+                 : "=a"(previous), "+m"(*ptr)
+                 : "r"(desired), "0"(expected)
+                 : "memory", "cc");
+    return previous;
+}
+
+static inline uint32_t meow_atomic_fetch_add_u32(volatile uint32_t* ptr, uint32_t value) {
+    asm volatile("lock; xaddl %0, %1" : "+r"(value), "+m"(*ptr) :: "memory", "cc");
+    return value;
+}
+
+static inline void* meow_atomic_xchg_ptr(void* volatile* ptr, void* value) {
+    return (void*)meow_atomic_xchg_u32((volatile uint32_t*)ptr, (uint32_t)value);
+}
+
+static inline void* meow_atomic_cmpxchg_ptr(void* volatile* ptr, void* expected, void* desired) {
+    return (void*)meow_atomic_cmpxchg_u32((volatile uint32_t*)ptr, (uint32_t)expected,
+                                          (uint32_t)desired);
+}
+
+#elif defined(__aarch64__)
+
+/* Load-acquire / store-release exclusive loops with a trailing full
+ * barrier, matching the x86 locked instructions */
+static inline uint32_t meow_atomic_xchg_u32(volatile uint32_t* ptr, uint32_t value) {
+    uint32_t previous, failed;
+    asm volatile("1: ldaxr %w0, %2\n"
+                 "   stlxr %w1, %w3, %2\n"
+                 "   cbnz %w1, 1b\n"
+                 "   dmb ish"
+                 : "=&r"(previous), "=&r"(failed), "+Q"(*ptr)
+                 : "r"(value)
+                 : "memory");
+    return previous;
+}
+
+static inline uint32_t meow_atomic_cmpxchg_u32(volatile uint32_t* ptr, uint32_t expected,
+                                               uint32_t desired) {
+    uint32_t previous, failed;
+    asm volatile("1: ldaxr %w0, %2\n"
+                 "   cmp %w0, %w3\n"
+                 "   b.ne 2f\n"
+                 "   stlxr %w1, %w4, %2\n"
+                 "   cbnz %w1, 1b\n"
+                 "2: dmb ish"
+                 : "=&r"(previous), "=&r"(failed), "+Q"(*ptr)
+                 : "r"(expected), "r"(desired)
+                 : "memory", "cc");
+    return previous;
+}
+
+static inline uint32_t meow_atomic_fetch_add_u32(volatile uint32_t* ptr, uint32_t value) {
+    uint32_t previous, sum, failed;
+    asm volatile("1: ldaxr %w0, %3\n"
+                 "   add %w1, %w0, %w4\n"
+                 "   stlxr %w2, %w1, %3\n"
+                 "   cbnz %w2, 1b\n"
+                 "   dmb ish"
+                 : "=&r"(previous), "=&r"(sum), "=&r"(failed), "+Q"(*ptr)
+                 : "r"(value)
+                 : "memory");
+    return previous;
+}
+
+static inline void* meow_atomic_xchg_ptr(void* volatile* ptr, void* value) {
+    void* previous;
+    uint32_t failed;
+    asm volatile("1: ldaxr %0, %2\n"
+                 "   stlxr %w1, %3, %2\n"
+                 "   cbnz %w1, 1b\n"
+                 "   dmb ish"
+                 : "=&r"(previous), "=&r"(failed), "+Q"(*ptr)
+                 : "r"(value)
+                 : "memory");
+    return previous;
+}
+
+static inline void* meow_atomic_cmpxchg_ptr(void* volatile* ptr, void* expected, void* desired) {
+    void* previous;
+    uint32_t failed;
+    asm volatile("1: ldaxr %0, %2\n"
+                 "   cmp %0, %3\n"
+                 "   b.ne 2f\n"
+                 "   stlxr %w1, %4, %2\n"
+                 "   cbnz %w1, 1b\n"
+                 "2: dmb ish"
+                 : "=&r"(previous), "=&r"(failed), "+Q"(*ptr)
+                 : "r"(expected), "r"(desired)
+                 : "memory", "cc");
+    return previous;
+}
+
+#endif
+
+/* ============================================================================
+ * ACQUIRE / RELEASE
+ * ============================================================================ */
+
+/* Later accesses can't move before this load */
+static inline uint32_t meow_load_acquire_u32(const volatile uint32_t* ptr) {
+#if defined(__aarch64__)
+    uint32_t value;
+    asm volatile("ldar %w0, %1" : "=r"(value) : "Q"(*ptr) : "memory");
+    return value;
+#else
+    uint32_t value = *ptr;
+    meow_barrier();
+    return value;
+#endif
+}
+
+/* Earlier accesses can't move after this store */
+static inline void meow_store_release_u32(volatile uint32_t* ptr, uint32_t value) {
+#if defined(__aarch64__)
+    asm volatile("stlr %w1, %0" : "=Q"(*ptr) : "r"(value) : "memory");
+#else
+    meow_barrier();
+    *ptr = value;
+#endif
+}
+
+/* ============================================================================
+ * ATOMIC COUNTERS
+ * ============================================================================ */
+
+static inline uint32_t meow_atomic_read(const meow_atomic_t* atomic) {
+    return atomic->value;
+}
+
+static inline void meow_atomic_set(meow_atomic_t* atomic, uint32_t value) {
+    atomic->value = value;
+}
+
+static inline uint32_t meow_atomic_fetch_add(meow_atomic_t* atomic, uint32_t value) {
+    return meow_atomic_fetch_add_u32(&atomic->value, value);
+}
+
+static inline uint32_t meow_atomic_add_return(meow_atomic_t* atomic, uint32_t value) {
+    return meow_atomic_fetch_add_u32(&atomic->value, value) + value;
+}
+
+static inline void meow_atomic_inc(meow_atomic_t* atomic) {
+    meow_atomic_fetch_add_u32(&atomic->value, 1);
+}
+
+static inline void meow_atomic_dec(meow_atomic_t* atomic) {
+    meow_atomic_fetch_add_u32(&atomic->value, (uint32_t)-1);
+}
+
+#endif /* MEOW_HAL_ATOMIC_H */
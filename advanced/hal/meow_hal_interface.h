@@ -16,7 +16,7 @@
  * ============================================================================ */
 
 /* HAL constants */
-#define MEOW_HAL_MAX_DEBUG_STRING_LEN   256
+#define MEOW_HAL_MAX_DEBUG_STRING_LEN   512     /* A whole meow_log line */
 #define MEOW_HAL_MAX_IRQ_HANDLERS       256
 #define MEOW_HAL_INVALID_IRQ            0xFF
 
@@ -63,13 +63,36 @@ struct hal_cpu_ops {
     /* CPU feature detection */
     uint32_t (*get_cpu_features)(void);
     const char* (*get_cpu_vendor)(void);
-    uint32_t (*get_cpu_frequency)(void);
+    uint32_t (*get_cpu_frequency)(void);    /* kHz, 0 if unknown */
     
     /* Power management */
-    meow_error_t (*enter_sleep)(uint8_t sleep_level);
+    meow_error_t (*enter_sleep)(uint8_t sleep_level);  /* Enables interrupts, waits for one */
     meow_error_t (*exit_sleep)(void);
+    
+    /* Kernel thread contexts. init_context lays out a new stack so that the
+     * first switch to it calls entry(arg); entry must never return. */
+    void* (*init_context)(void* stack_top, void (*entry)(void* arg), void* arg);
+    void (*switch_context)(void** save_sp, void* next_sp);
+
+    /* Multiprocessing. CPUs are numbered from 0, the boot CPU. Each started
+     * CPU calls entry with interrupts disabled; entry must never return. */
+    meow_error_t (*start_secondary_cpus)(void (*entry)(void));
+    uint32_t (*get_cpu_id)(void);
+    uint32_t (*get_cpu_count)(void);       /* CPUs online */
+    meow_error_t (*send_reschedule)(uint32_t cpu);  /* Interrupt @cpu, running its exit hook */
+
+    /* Per-CPU data: where @cpu finds its copy of the per-CPU section,
+     * relative to the section. Set before the CPU is started. */
+    meow_error_t (*set_percpu_offset)(uint32_t cpu, uintptr_t offset);
 };
 
+/* Page flags for map_page / set_page_flags */
+#define MEOW_PAGE_PRESENT       0x01
+#define MEOW_PAGE_WRITABLE      0x02
+#define MEOW_PAGE_USER          0x04
+#define MEOW_PAGE_NOCACHE       0x08    /* Device memory */
+#define MEOW_PAGE_GLOBAL        0x10    /* Same in every address space */
+
 /**
  * hal_memory_ops - Memory management operations
  */
@@ -80,7 +103,8 @@ struct hal_memory_ops {
     uint32_t (*get_available_size)(void);
     void* (*get_kernel_end)(void);
     
-    /* Memory mapping and protection */
+    /* Memory mapping and protection (init_paging runs once the PMM is up) */
+    meow_error_t (*init_paging)(void);
     meow_error_t (*map_page)(void* virtual_addr, void* physical_addr, uint32_t flags);
     meow_error_t (*unmap_page)(void* virtual_addr);
     meow_error_t (*set_page_flags)(void* virtual_addr, uint32_t flags);
@@ -115,6 +139,10 @@ struct hal_interrupt_ops {
     /* Interrupt information */
     uint8_t (*get_current_irq)(void);
     uint32_t (*get_irq_count)(uint8_t irq);
+    
+    /* Runs on every IRQ after the EOI, with interrupts still disabled;
+     * the place to preempt the interrupted thread */
+    meow_error_t (*set_exit_hook)(void (*hook)(void));
 };
 
 /**
@@ -130,10 +158,14 @@ struct hal_timer_ops {
     meow_error_t (*stop)(void);
     meow_error_t (*set_frequency)(uint32_t frequency);
     uint32_t (*get_frequency)(void);
+    meow_error_t (*set_oneshot)(uint64_t delta_ns); /* Stop the tick, fire once */
+    meow_error_t (*set_periodic)(void);             /* Resume the periodic tick */
+    meow_error_t (*start_local)(void);              /* Periodic tick on a secondary CPU */
     
     /* Time measurement */
     uint64_t (*get_ticks)(void);
     uint64_t (*get_milliseconds)(void);
+    uint64_t (*get_ns)(void);               /* Monotonic nanoseconds since boot */
     meow_error_t (*sleep)(uint32_t milliseconds);
     
     /* Timer callbacks */
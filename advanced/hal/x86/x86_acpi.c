@@ -0,0 +1,255 @@
+/* advanced/hal/x86/x86_acpi.c - ACPI Table Discovery
+ *
+ * Finds the RSDP, walks the RSDT/XSDT and parses the MADT into an
+ * x86_madt_info_t. Runs before paging is enabled, so the tables are
+ * read straight from physical memory.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "x86_meow_hal_interface.h"
+#include "../../kernel/meow_util.h"
+
+/* BIOS areas searched for the RSDP */
+#define ACPI_EBDA_POINTER    0x40E      /* Real mode segment of the EBDA */
+#define ACPI_EBDA_SEARCH     1024
+#define ACPI_BIOS_START      0xE0000
+#define ACPI_BIOS_END        0x100000
+
+/* MADT entry types */
+#define MADT_LOCAL_APIC          0
+#define MADT_IO_APIC             1
+#define MADT_SOURCE_OVERRIDE     2
+#define MADT_LAPIC_ADDR_OVERRIDE 5
+
+typedef struct acpi_rsdp {
+    char signature[8];              /* "RSD PTR " */
+    uint8_t checksum;
+    char oem_id[6];
+    uint8_t revision;               /* 0 for ACPI 1.0, 2 and up has the XSDT */
+    uint32_t rsdt_address;
+    uint32_t length;
+    uint64_t xsdt_address;
+    uint8_t extended_checksum;
+    uint8_t reserved[3];
+} __attribute__((packed)) acpi_rsdp_t;
+
+typedef struct acpi_sdt_header {
+    char signature[4];
+    uint32_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[6];
+    char oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} __attribute__((packed)) acpi_sdt_header_t;
+
+typedef struct acpi_madt {
+    acpi_sdt_header_t header;
+    uint32_t lapic_address;
+    uint32_t flags;
+} __attribute__((packed)) acpi_madt_t;
+
+typedef struct madt_entry_header {
+    uint8_t type;
+    uint8_t length;
+} __attribute__((packed)) madt_entry_header_t;
+
+typedef struct madt_local_apic {
+    madt_entry_header_t header;
+    uint8_t processor_id;
+    uint8_t apic_id;
+    uint32_t flags;                 /* Bit 0: enabled */
+} __attribute__((packed)) madt_local_apic_t;
+
+typedef struct madt_io_apic {
+    madt_entry_header_t header;
+    uint8_t id;
+    uint8_t reserved;
+    uint32_t address;
+    uint32_t gsi_base;
+} __attribute__((packed)) madt_io_apic_t;
+
+typedef struct madt_source_override {
+    madt_entry_header_t header;
+    uint8_t bus;
+    uint8_t source;
+    uint32_t gsi;
+    uint16_t flags;
+} __attribute__((packed)) madt_source_override_t;
+
+typedef struct madt_lapic_addr_override {
+    madt_entry_header_t header;
+    uint16_t reserved;
+    uint64_t address;
+} __attribute__((packed)) madt_lapic_addr_override_t;
+
+/* Global ACPI state */
+static x86_madt_info_t madt_info;
+static uint8_t madt_found = 0;
+
+/* ============================================================================
+ * INTERNAL HELPERS
+ * ============================================================================ */
+
+static uint8_t checksum_ok_internal(const void* data, uint32_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint8_t sum = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        sum += bytes[i];
+    }
+    return sum == 0;
+}
+
+static const acpi_rsdp_t* scan_rsdp_internal(uint32_t start, uint32_t end) {
+    for (uint32_t addr = start; addr + sizeof(acpi_rsdp_t) <= end; addr += 16) {
+        const acpi_rsdp_t* rsdp = (const acpi_rsdp_t*)addr;
+        if (meow_memcmp(rsdp->signature, "RSD PTR ", 8) == 0 && checksum_ok_internal(rsdp, 20)) {
+            return rsdp;
+        }
+    }
+    return NULL;
+}
+
+static const acpi_rsdp_t* find_rsdp_internal(void) {
+    volatile uint16_t* bda = (volatile uint16_t*)ACPI_EBDA_POINTER;
+    __asm__ volatile("" : "+r"(bda));   /* Hide the low address from -Warray-bounds */
+    uint32_t ebda = (uint32_t)(*bda) << 4;
+    const acpi_rsdp_t* rsdp = NULL;
+
+    if (ebda >= 0x80000 && ebda < 0xA0000) {
+        rsdp = scan_rsdp_internal(ebda, ebda + ACPI_EBDA_SEARCH);
+    }
+    if (!rsdp) {
+        rsdp = scan_rsdp_internal(ACPI_BIOS_START, ACPI_BIOS_END);
+    }
+    return rsdp;
+}
+
+/* Find a table by signature through the XSDT when usable, else the RSDT */
+static const acpi_sdt_header_t* find_table_internal(const acpi_rsdp_t* rsdp, const char* signature) {
+    uint8_t use_xsdt = rsdp->revision >= 2 && rsdp->xsdt_address != 0 &&
+                       rsdp->xsdt_address < 0x100000000ULL;
+    const acpi_sdt_header_t* root = use_xsdt ?
+        (const acpi_sdt_header_t*)(uint32_t)rsdp->xsdt_address :
+        (const acpi_sdt_header_t*)rsdp->rsdt_address;
+
+    if (!root || !checksum_ok_internal(root, root->length)) {
+        meow_log(MEOW_LOG_HISS, "x86: ACPI root table at 0x%08x is corrupt", (uint32_t)root);
+        return NULL;
+    }
+
+    uint32_t entry_size = use_xsdt ? 8 : 4;
+    uint32_t entries = (root->length - sizeof(acpi_sdt_header_t)) / entry_size;
+    const uint8_t* list = (const uint8_t*)root + sizeof(acpi_sdt_header_t);
+
+    for (uint32_t i = 0; i < entries; i++) {
+        uint64_t address = use_xsdt ? *(const uint64_t*)(list + i * 8) :
+                                      *(const uint32_t*)(list + i * 4);
+        if (address == 0 || address >= 0x100000000ULL) {
+            continue;
+        }
+
+        const acpi_sdt_header_t* table = (const acpi_sdt_header_t*)(uint32_t)address;
+        if (meow_memcmp(table->signature, signature, 4) == 0 &&
+            checksum_ok_internal(table, table->length)) {
+            return table;
+        }
+    }
+    return NULL;
+}
+
+static void parse_madt_internal(const acpi_madt_t* madt) {
+    meow_memset(&madt_info, 0, sizeof(madt_info));
+    madt_info.lapic_address = madt->lapic_address;
+    madt_info.flags = madt->flags;
+
+    const uint8_t* entry = (const uint8_t*)madt + sizeof(acpi_madt_t);
+    const uint8_t* end = (const uint8_t*)madt + madt->header.length;
+
+    while (entry + sizeof(madt_entry_header_t) <= end) {
+        const madt_entry_header_t* header = (const madt_entry_header_t*)entry;
+        if (header->length < sizeof(madt_entry_header_t) || entry + header->length > end) {
+            break;
+        }
+
+        switch (header->type) {
+            case MADT_LOCAL_APIC: {
+                const madt_local_apic_t* lapic = (const madt_local_apic_t*)entry;
+                if ((lapic->flags & 1) && madt_info.cpu_count < X86_MAX_CPUS) {
+                    madt_info.cpu_apic_ids[madt_info.cpu_count++] = lapic->apic_id;
+                }
+                break;
+            }
+            case MADT_IO_APIC: {
+                const madt_io_apic_t* ioapic = (const madt_io_apic_t*)entry;
+                if (madt_info.ioapic_count < X86_MAX_IOAPICS) {
+                    x86_madt_ioapic_t* info = &madt_info.ioapics[madt_info.ioapic_count++];
+                    info->id = ioapic->id;
+                    info->address = ioapic->address;
+                    info->gsi_base = ioapic->gsi_base;
+                }
+                break;
+            }
+            case MADT_SOURCE_OVERRIDE: {
+                const madt_source_override_t* iso = (const madt_source_override_t*)entry;
+                if (iso->bus == 0 && madt_info.override_count < X86_MAX_IRQ_OVERRIDES) {
+                    x86_madt_override_t* info = &madt_info.overrides[madt_info.override_count++];
+                    info->source_irq = iso->source;
+                    info->gsi = iso->gsi;
+                    info->flags = iso->flags;
+                }
+                break;
+            }
+            case MADT_LAPIC_ADDR_OVERRIDE: {
+                const madt_lapic_addr_override_t* override =
+                    (const madt_lapic_addr_override_t*)entry;
+                if (override->address < 0x100000000ULL) {
+                    madt_info.lapic_address = (uint32_t)override->address;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        entry += header->length;
+    }
+}
+
+/* ============================================================================
+ * ACPI INTERFACE
+ * ============================================================================ */
+
+/* Locate and parse the MADT */
+meow_error_t x86_acpi_init(void) {
+    if (madt_found) {
+        return MEOW_SUCCESS;
+    }
+
+    const acpi_rsdp_t* rsdp = find_rsdp_internal();
+    if (!rsdp) {
+        meow_log(MEOW_LOG_MEOW, "x86: No ACPI RSDP found");
+        return MEOW_ERROR_DEVICE_NOT_FOUND;
+    }
+
+    const acpi_madt_t* madt = (const acpi_madt_t*)find_table_internal(rsdp, "APIC");
+    if (!madt) {
+        meow_log(MEOW_LOG_MEOW, "x86: ACPI has no MADT");
+        return MEOW_ERROR_DEVICE_NOT_FOUND;
+    }
+
+    parse_madt_internal(madt);
+    madt_found = 1;
+    meow_log(MEOW_LOG_CHIRP, "x86: MADT: %u CPUs, %u I/O APICs, %u overrides, LAPIC at 0x%08x",
+             madt_info.cpu_count, madt_info.ioapic_count, madt_info.override_count,
+             madt_info.lapic_address);
+    return MEOW_SUCCESS;
+}
+
+/* Parsed MADT, or NULL when none was found */
+const x86_madt_info_t* x86_acpi_get_madt(void) {
+    return madt_found ? &madt_info : NULL;
+}
@@ -0,0 +1,393 @@
+/* advanced/hal/x86/x86_apic.c - Local APIC and I/O APIC
+ *
+ * Replaces the 8259 PIC when the ACPI MADT describes an I/O APIC. ISA
+ * IRQs keep their vectors (32 + irq) so the IRQ stubs and the handler
+ * table are shared with the PIC path; only masking and EOI change. EOI
+ * becomes a single MMIO write to the Local APIC.
+ *
+ * Each CPU's Local APIC timer and the reschedule IPI take the IRQ lines
+ * right after the ISA ones. The PIT stays the boot CPU's tick and the
+ * clock; the Local APIC timers only give the other CPUs a tick.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "x86_meow_hal_interface.h"
+#include "../../kernel/meow_util.h"
+#include "../../kernel/meow_lock.h"
+
+/* IA32_APIC_BASE MSR */
+#define APIC_BASE_MSR            0x1B
+#define APIC_BASE_ENABLE         0x800
+
+/* Local APIC registers (byte offsets) */
+#define LAPIC_ID                 0x020
+#define LAPIC_VERSION            0x030
+#define LAPIC_TPR                0x080
+#define LAPIC_EOI                0x0B0
+#define LAPIC_SVR                0x0F0
+#define LAPIC_SVR_ENABLE         0x100
+#define LAPIC_ICR_LOW            0x300
+#define LAPIC_ICR_HIGH           0x310
+#define LAPIC_ICR_PENDING        (1u << 12)
+#define LAPIC_ICR_POLLS          100000
+#define LAPIC_LVT_TIMER          0x320
+#define LAPIC_LVT_MASKED         (1u << 16)
+#define LAPIC_TIMER_PERIODIC     (1u << 17)
+#define LAPIC_TIMER_INITIAL      0x380
+#define LAPIC_TIMER_CURRENT      0x390
+#define LAPIC_TIMER_DIVIDE       0x3E0
+#define LAPIC_TIMER_DIVIDE_16    0x3
+#define LAPIC_CALIBRATE_US       10000
+
+/* I/O APIC registers */
+#define IOAPIC_REGSEL            0x00
+#define IOAPIC_WINDOW            0x10
+#define IOAPIC_REG_VERSION       0x01
+#define IOAPIC_REG_REDIRECTION   0x10
+#define IOAPIC_RTE_POLARITY_LOW  (1u << 13)
+#define IOAPIC_RTE_LEVEL         (1u << 15)
+#define IOAPIC_RTE_MASKED        (1u << 16)
+
+/* One I/O APIC and the global system interrupts it serves. The lock
+ * covers every REGSEL/WINDOW pair and redirection entry update. */
+typedef struct ioapic {
+    meow_spinlock_t lock;
+    volatile uint32_t* base;
+    uint32_t gsi_base;
+    uint32_t entries;
+} ioapic_t;
+
+/* Where an ISA IRQ ends up */
+typedef struct isa_route {
+    ioapic_t* ioapic;               /* NULL when no I/O APIC serves the IRQ */
+    uint32_t pin;
+    uint32_t low;                   /* Redirection entry, low dword */
+} isa_route_t;
+
+MEOW_LOCK_CLASS(ioapic_lock_class, "ioapic");
+
+/* Global APIC state */
+static volatile uint32_t* lapic_base = NULL;
+static ioapic_t ioapics[X86_MAX_IOAPICS];
+static uint32_t ioapic_count = 0;
+static isa_route_t isa_routes[X86_ISA_IRQS];
+static uint8_t bsp_apic_id = 0;
+static uint8_t apic_enabled = 0;
+static uint32_t lapic_timer_count = 0;  /* Initial count for one tick, 0 until calibrated */
+
+/* ============================================================================
+ * REGISTER ACCESS
+ * ============================================================================ */
+
+static inline uint32_t lapic_read(uint32_t reg) {
+    return lapic_base[reg / 4];
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t value) {
+    lapic_base[reg / 4] = value;
+}
+
+/* Caller holds ioapic->lock: anything touching REGSEL in between would
+ * make the WINDOW access hit another register */
+static inline void ioapic_write_internal(ioapic_t* ioapic, uint32_t reg, uint32_t value) {
+    ioapic->base[IOAPIC_REGSEL / 4] = reg;
+    ioapic->base[IOAPIC_WINDOW / 4] = value;
+}
+
+static uint32_t ioapic_read(ioapic_t* ioapic, uint32_t reg) {
+    uint32_t flags = meow_spin_lock_irqsave(&ioapic->lock);
+    ioapic->base[IOAPIC_REGSEL / 4] = reg;
+    uint32_t value = ioapic->base[IOAPIC_WINDOW / 4];
+    meow_spin_unlock_irqrestore(&ioapic->lock, flags);
+    return value;
+}
+
+static void ioapic_write(ioapic_t* ioapic, uint32_t reg, uint32_t value) {
+    uint32_t flags = meow_spin_lock_irqsave(&ioapic->lock);
+    ioapic_write_internal(ioapic, reg, value);
+    meow_spin_unlock_irqrestore(&ioapic->lock, flags);
+}
+
+/* Caller holds ioapic->lock */
+static void ioapic_write_route_internal(ioapic_t* ioapic, uint32_t pin, uint32_t low,
+                                        uint8_t apic_id) {
+    /* Mask first so the entry is never live half-written */
+    ioapic_write_internal(ioapic, IOAPIC_REG_REDIRECTION + pin * 2, IOAPIC_RTE_MASKED);
+    ioapic_write_internal(ioapic, IOAPIC_REG_REDIRECTION + pin * 2 + 1, (uint32_t)apic_id << 24);
+    ioapic_write_internal(ioapic, IOAPIC_REG_REDIRECTION + pin * 2, low);
+}
+
+static void ioapic_write_route(ioapic_t* ioapic, uint32_t pin, uint32_t low, uint8_t apic_id) {
+    uint32_t flags = meow_spin_lock_irqsave(&ioapic->lock);
+    ioapic_write_route_internal(ioapic, pin, low, apic_id);
+    meow_spin_unlock_irqrestore(&ioapic->lock, flags);
+}
+
+/* Set or clear the mask bit of an ISA IRQ's redirection entry */
+static void ioapic_mask_route(isa_route_t* route, uint8_t masked) {
+    uint32_t flags = meow_spin_lock_irqsave(&route->ioapic->lock);
+    if (masked) {
+        route->low |= IOAPIC_RTE_MASKED;
+    } else {
+        route->low &= ~IOAPIC_RTE_MASKED;
+    }
+    ioapic_write_internal(route->ioapic, IOAPIC_REG_REDIRECTION + route->pin * 2, route->low);
+    meow_spin_unlock_irqrestore(&route->ioapic->lock, flags);
+}
+
+static ioapic_t* ioapic_for_gsi(uint32_t gsi) {
+    for (uint32_t i = 0; i < ioapic_count; i++) {
+        if (gsi >= ioapics[i].gsi_base && gsi < ioapics[i].gsi_base + ioapics[i].entries) {
+            return &ioapics[i];
+        }
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * APIC SETUP
+ * ============================================================================ */
+
+/* Bring up the Local APIC and route the ISA IRQs through the I/O APICs */
+meow_error_t x86_apic_init(void) {
+    if (apic_enabled) {
+        return MEOW_ERROR_ALREADY_INITIALIZED;
+    }
+
+    if (!x86_cpuid_supported()) {
+        return MEOW_ERROR_NOT_SUPPORTED;
+    }
+    uint32_t eax, ebx, ecx, edx;
+    x86_cpuid(1, &eax, &ebx, &ecx, &edx);
+    if (!(edx & X86_FEATURE_APIC) || !(edx & X86_FEATURE_MSR)) {
+        return MEOW_ERROR_NOT_SUPPORTED;
+    }
+    if (x86_acpi_init() != MEOW_SUCCESS) {
+        return MEOW_ERROR_DEVICE_NOT_FOUND;
+    }
+
+    const x86_madt_info_t* madt = x86_acpi_get_madt();
+    if (madt->ioapic_count == 0 || madt->lapic_address == 0) {
+        meow_log(MEOW_LOG_MEOW, "x86: MADT lists no usable I/O APIC");
+        return MEOW_ERROR_DEVICE_NOT_FOUND;
+    }
+
+    /* Local APIC: global enable, then software enable with the spurious vector */
+    lapic_base = (volatile uint32_t*)madt->lapic_address;
+    uint64_t apic_msr = x86_rdmsr(APIC_BASE_MSR);
+    x86_wrmsr(APIC_BASE_MSR, (apic_msr & 0xFFF) | madt->lapic_address | APIC_BASE_ENABLE);
+    x86_idt_set_gate(X86_APIC_SPURIOUS_VECTOR, (uint32_t)x86_apic_spurious_stub, 0x08, 0x8E);
+    x86_idt_set_gate(X86_APIC_TIMER_VECTOR, (uint32_t)x86_apic_timer_stub, 0x08, 0x8E);
+    x86_idt_set_gate(X86_APIC_RESCHEDULE_VECTOR, (uint32_t)x86_apic_reschedule_stub, 0x08, 0x8E);
+    lapic_write(LAPIC_TPR, 0);
+    lapic_write(LAPIC_SVR, LAPIC_SVR_ENABLE | X86_APIC_SPURIOUS_VECTOR);
+    bsp_apic_id = (uint8_t)(lapic_read(LAPIC_ID) >> 24);
+
+    /* I/O APICs: learn their sizes and mask every pin */
+    ioapic_count = 0;
+    for (uint32_t i = 0; i < madt->ioapic_count; i++) {
+        ioapic_t* ioapic = &ioapics[ioapic_count++];
+        meow_spin_init(&ioapic->lock, &ioapic_lock_class);
+        ioapic->base = (volatile uint32_t*)madt->ioapics[i].address;
+        ioapic->gsi_base = madt->ioapics[i].gsi_base;
+        ioapic->entries = ((ioapic_read(ioapic, IOAPIC_REG_VERSION) >> 16) & 0xFF) + 1;
+        for (uint32_t pin = 0; pin < ioapic->entries; pin++) {
+            ioapic_write(ioapic, IOAPIC_REG_REDIRECTION + pin * 2, IOAPIC_RTE_MASKED);
+        }
+    }
+
+    /* ISA IRQs are identity mapped, edge triggered and active high unless
+     * the MADT overrides them. An IRQ whose pin another IRQ was moved to
+     * (IRQ 2 when the timer is on GSI 2) gets no route of its own. */
+    for (uint32_t irq = 0; irq < X86_ISA_IRQS; irq++) {
+        uint32_t gsi = irq;
+        uint16_t flags = 0;
+        uint8_t overridden = 0;
+        uint8_t taken = 0;
+        for (uint32_t i = 0; i < madt->override_count; i++) {
+            if (madt->overrides[i].source_irq == irq) {
+                gsi = madt->overrides[i].gsi;
+                flags = madt->overrides[i].flags;
+                overridden = 1;
+                break;
+            }
+            if (madt->overrides[i].gsi == irq) {
+                taken = 1;
+            }
+        }
+
+        isa_route_t* route = &isa_routes[irq];
+        if (!overridden && taken) {
+            route->ioapic = NULL;
+            continue;
+        }
+        route->ioapic = ioapic_for_gsi(gsi);
+        route->pin = route->ioapic ? gsi - route->ioapic->gsi_base : 0;
+        route->low = (32 + irq) | IOAPIC_RTE_MASKED;
+        if ((flags & X86_MPS_POLARITY_MASK) == X86_MPS_POLARITY_LOW) {
+            route->low |= IOAPIC_RTE_POLARITY_LOW;
+        }
+        if ((flags & X86_MPS_TRIGGER_MASK) == X86_MPS_TRIGGER_LEVEL) {
+            route->low |= IOAPIC_RTE_LEVEL;
+        }
+        if (route->ioapic) {
+            ioapic_write_route(route->ioapic, route->pin, route->low, bsp_apic_id);
+        }
+    }
+
+    /* The PIC stays programmed but fully masked */
+    x86_pic_disable_all_irqs();
+    x86_irq_eoi = x86_apic_eoi;
+    apic_enabled = 1;
+
+    meow_log(MEOW_LOG_CHIRP, "x86: APIC mode: LAPIC 0x%08x (id %u, version 0x%x), %u I/O APICs",
+             madt->lapic_address, bsp_apic_id, lapic_read(LAPIC_VERSION) & 0xFF, ioapic_count);
+    return MEOW_SUCCESS;
+}
+
+/* Enable the Local APIC of an application processor. The I/O APICs and
+ * the MMIO mappings are shared and already set up by the boot CPU. */
+meow_error_t x86_apic_init_ap(void) {
+    if (!apic_enabled) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+
+    uint64_t apic_msr = x86_rdmsr(APIC_BASE_MSR);
+    x86_wrmsr(APIC_BASE_MSR, apic_msr | APIC_BASE_ENABLE);
+    lapic_write(LAPIC_TPR, 0);
+    lapic_write(LAPIC_SVR, LAPIC_SVR_ENABLE | X86_APIC_SPURIOUS_VECTOR);
+    return MEOW_SUCCESS;
+}
+
+/* Map the APIC registers uncached; called while paging is being set up */
+meow_error_t x86_apic_map_mmio(void) {
+    if (!apic_enabled) {
+        return MEOW_SUCCESS;
+    }
+
+    uint32_t flags = X86_PTE_PRESENT | X86_PTE_WRITABLE | X86_PTE_CACHE_DISABLE |
+                     X86_PTE_WRITE_THROUGH | X86_PTE_GLOBAL;
+    uint32_t lapic_page = (uint32_t)lapic_base & X86_PAGE_ALIGN_MASK;
+    MEOW_RETURN_IF_ERROR(x86_paging_map_page(lapic_page, lapic_page, flags));
+    for (uint32_t i = 0; i < ioapic_count; i++) {
+        uint32_t page = (uint32_t)ioapics[i].base & X86_PAGE_ALIGN_MASK;
+        MEOW_RETURN_IF_ERROR(x86_paging_map_page(page, page, flags));
+    }
+    return MEOW_SUCCESS;
+}
+
+/* ============================================================================
+ * APIC INTERRUPT CONTROL
+ * ============================================================================ */
+
+uint8_t x86_apic_is_enabled(void) {
+    return apic_enabled;
+}
+
+uint8_t x86_apic_get_id(void) {
+    return apic_enabled ? (uint8_t)(lapic_read(LAPIC_ID) >> 24) : 0;
+}
+
+/* End of interrupt: one MMIO write */
+void x86_apic_eoi(uint8_t irq) {
+    (void)irq;
+    lapic_write(LAPIC_EOI, 0);
+}
+
+/* Send an IPI and wait for the Local APIC to accept it. Interrupts stay
+ * off so an IPI sent from a handler can't land between the two writes. */
+meow_error_t x86_apic_send_ipi(uint8_t apic_id, uint32_t icr_low) {
+    if (!apic_enabled) {
+        return MEOW_ERROR_NOT_SUPPORTED;
+    }
+
+    meow_error_t result = MEOW_SUCCESS;
+    uint32_t flags = meow_irq_save();
+    lapic_write(LAPIC_ICR_HIGH, (uint32_t)apic_id << 24);
+    lapic_write(LAPIC_ICR_LOW, icr_low);     /* Writing the low dword sends it */
+
+    for (uint32_t polls = 0; lapic_read(LAPIC_ICR_LOW) & LAPIC_ICR_PENDING; polls++) {
+        if (polls > LAPIC_ICR_POLLS) {
+            result = MEOW_ERROR_TIMEOUT;
+            break;
+        }
+    }
+    meow_irq_restore(flags);
+    return result;
+}
+
+/* Count the boot CPU's Local APIC timer over a fixed delay. All of them
+ * run off the same bus clock, so the count holds for every CPU. */
+meow_error_t x86_apic_timer_calibrate(uint32_t frequency) {
+    if (!apic_enabled) {
+        return MEOW_ERROR_NOT_SUPPORTED;
+    }
+    if (frequency == 0) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    lapic_write(LAPIC_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_16);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED | X86_APIC_TIMER_VECTOR);
+    lapic_write(LAPIC_TIMER_INITIAL, 0xFFFFFFFF);
+    x86_delay_us(LAPIC_CALIBRATE_US);
+    uint32_t counted = 0xFFFFFFFF - lapic_read(LAPIC_TIMER_CURRENT);
+    lapic_write(LAPIC_TIMER_INITIAL, 0);     /* Stops it */
+
+    lapic_timer_count = (uint32_t)(((uint64_t)counted * (1000000 / LAPIC_CALIBRATE_US)) /
+                                   frequency);
+    if (lapic_timer_count == 0) {
+        return MEOW_ERROR_HARDWARE_FAILURE;
+    }
+
+    meow_log(MEOW_LOG_CHIRP, "x86: LAPIC timer: %u counts per %u Hz tick",
+             lapic_timer_count, frequency);
+    return MEOW_SUCCESS;
+}
+
+/* Start the calling CPU's Local APIC timer, periodic at the calibrated rate */
+meow_error_t x86_apic_timer_start(void) {
+    if (lapic_timer_count == 0) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+
+    lapic_write(LAPIC_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_16);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_TIMER_PERIODIC | X86_APIC_TIMER_VECTOR);
+    lapic_write(LAPIC_TIMER_INITIAL, lapic_timer_count);
+    return MEOW_SUCCESS;
+}
+
+meow_error_t x86_ioapic_enable_irq(uint8_t irq) {
+    if (irq >= X86_ISA_IRQS || !isa_routes[irq].ioapic) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    ioapic_mask_route(&isa_routes[irq], 0);
+    return MEOW_SUCCESS;
+}
+
+meow_error_t x86_ioapic_disable_irq(uint8_t irq) {
+    if (irq >= X86_ISA_IRQS || !isa_routes[irq].ioapic) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    ioapic_mask_route(&isa_routes[irq], 1);
+    return MEOW_SUCCESS;
+}
+
+/* Deliver an IRQ to another CPU */
+meow_error_t x86_ioapic_set_affinity(uint8_t irq, uint8_t apic_id) {
+    if (!apic_enabled) {
+        return MEOW_ERROR_NOT_SUPPORTED;
+    }
+    if (irq >= X86_ISA_IRQS || !isa_routes[irq].ioapic) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    /* route->low is read under the lock so a concurrent mask change sticks */
+    isa_route_t* route = &isa_routes[irq];
+    uint32_t flags = meow_spin_lock_irqsave(&route->ioapic->lock);
+    ioapic_write_route_internal(route->ioapic, route->pin, route->low, apic_id);
+    meow_spin_unlock_irqrestore(&route->ioapic->lock, flags);
+    return MEOW_SUCCESS;
+}
@@ -1,6 +1,9 @@
 /* advanced/hal/x86/x86_descriptor_tables.c - Global Descriptor Table 
  *                                            Implementation
  *
+ * The boot CPU builds the table; every other CPU loads its own copy of
+ * it, so per-CPU segments can later differ between them.
+ *
  * Copyright (c) 2025 MeowKernel Project
  */
 
@@ -23,23 +26,29 @@ struct gdt_ptr {
     uint32_t base;          /* Base address of GDT */
 } __attribute__((packed));
 
-/* GDT Entries */
-static struct gdt_entry gdt[5];
-static struct gdt_ptr gdt_ptr;
+/* GDT Entries, one table per CPU */
+static struct gdt_entry gdt[X86_MAX_CPUS][X86_GDT_ENTRIES];
+static struct gdt_ptr gdt_ptr[X86_MAX_CPUS];
+static uint32_t gdt_percpu_base[X86_MAX_CPUS];
 
 /* ============================================================================
  * GDT IMPLEMENTATION (Fixed function names and logging)
  * ============================================================================ */
 
-/* Set a GDT entry */
+static void gdt_encode_internal(struct gdt_entry* entry, uint32_t base, uint32_t limit,
+                                uint8_t access, uint8_t gran) {
+    entry->base_low     = (base & 0xFFFF);
+    entry->base_middle  = (base >> 16) & 0xFF;
+    entry->base_high    = (base >> 24) & 0xFF;
+    entry->limit_low    = (limit & 0xFFFF);
+    entry->granularity  = ((limit >> 16) & 0x0F);
+    entry->granularity |= (gran & 0xF0);
+    entry->access       = access;
+}
+
+/* Set an entry in the boot CPU's GDT */
 static void gdt_set_gate(int32_t num, uint32_t base, uint32_t limit, uint8_t access, uint8_t gran) {
-    gdt[num].base_low     = (base & 0xFFFF);
-    gdt[num].base_middle  = (base >> 16) & 0xFF;
-    gdt[num].base_high    = (base >> 24) & 0xFF;
-    gdt[num].limit_low    = (limit & 0xFFFF);
-    gdt[num].granularity  = ((limit >> 16) & 0x0F);
-    gdt[num].granularity |= (gran & 0xF0);
-    gdt[num].access       = access;
+    gdt_encode_internal(&gdt[0][num], base, limit, access, gran);
 }
 
 /* Initialize the GDT */
@@ -47,8 +56,8 @@ meow_error_t x86_gdt_init(void) {
     meow_log(MEOW_LOG_CHIRP, "x86: Initializing Global Descriptor Table");
 
     /* Setup GDT pointer */
-    gdt_ptr.limit = (sizeof(struct gdt_entry) * 5) - 1;
-    gdt_ptr.base  = (uint32_t)&gdt;
+    gdt_ptr[0].limit = sizeof(gdt[0]) - 1;
+    gdt_ptr[0].base  = (uint32_t)&gdt[0];
 
     /* NULL descriptor */
     gdt_set_gate(0, 0, 0, 0, 0);
@@ -65,17 +74,52 @@ meow_error_t x86_gdt_init(void) {
     /* User data segment: Base=0, Limit=4GB, Access=0xF2, Granularity=0xCF */
     gdt_set_gate(4, 0, 0xFFFFFFFF, 0xF2, 0xCF);
 
+    /* Per-CPU data segment: flat until meow_percpu_init moves it */
+    gdt_set_gate(X86_GDT_PERCPU_INDEX, gdt_percpu_base[0], 0xFFFFFFFF, 0x92, 0xCF);
+
     /* Load the GDT */
-    x86_gdt_flush((uint32_t)&gdt_ptr);
+    x86_gdt_flush((uint32_t)&gdt_ptr[0]);
+    x86_load_fs(X86_GDT_PERCPU_SELECTOR);
 
-    meow_log(MEOW_LOG_CHIRP, "x86: GDT initialized with 5 segments");
+    meow_log(MEOW_LOG_CHIRP, "x86: GDT initialized with 5 segments and a per-CPU segment");
+    return MEOW_SUCCESS;
+}
+
+/* Give an application processor a copy of the boot CPU's GDT and load it */
+meow_error_t x86_gdt_load_cpu(uint32_t cpu) {
+    if (cpu == 0 || cpu >= X86_MAX_CPUS) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    meow_memcpy(gdt[cpu], gdt[0], sizeof(gdt[0]));
+    gdt_encode_internal(&gdt[cpu][X86_GDT_PERCPU_INDEX], gdt_percpu_base[cpu], 0xFFFFFFFF,
+                        0x92, 0xCF);
+    gdt_ptr[cpu].limit = sizeof(gdt[cpu]) - 1;
+    gdt_ptr[cpu].base  = (uint32_t)&gdt[cpu];
+    x86_gdt_flush((uint32_t)&gdt_ptr[cpu]);
+    x86_load_fs(X86_GDT_PERCPU_SELECTOR);
+    return MEOW_SUCCESS;
+}
+
+/* Base @cpu's per-CPU segment at @base. An application processor picks
+ * it up in x86_gdt_load_cpu; the boot CPU switches right away. */
+meow_error_t x86_gdt_set_percpu_base(uint32_t cpu, uint32_t base) {
+    if (cpu >= X86_MAX_CPUS) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    gdt_percpu_base[cpu] = base;
+    if (cpu == 0) {
+        gdt_set_gate(X86_GDT_PERCPU_INDEX, base, 0xFFFFFFFF, 0x92, 0xCF);
+        x86_load_fs(X86_GDT_PERCPU_SELECTOR);
+    }
     return MEOW_SUCCESS;
 }
 
 /* Set a specific GDT gate (for external use) */
 meow_error_t x86_gdt_set_gate(uint32_t num, uint32_t base, uint32_t limit,
                                uint8_t access, uint8_t granularity) {
-    if (num >= 5) {
+    if (num >= X86_GDT_ENTRIES) {
         meow_log(MEOW_LOG_YOWL, "x86: Invalid GDT entry number: %u", num);
         return MEOW_ERROR_INVALID_PARAMETER;
     }
@@ -87,7 +131,7 @@ meow_error_t x86_gdt_set_gate(uint32_t num, uint32_t base, uint32_t limit,
 
 /* Get GDT selector for a given index */
 uint32_t x86_gdt_get_selector(uint32_t index) {
-    if (index >= 5) {
+    if (index >= X86_GDT_ENTRIES) {
         meow_log(MEOW_LOG_YOWL, "x86: Invalid GDT selector index: %u", index);
         return 0;
     }
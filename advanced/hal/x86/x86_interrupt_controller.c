@@ -191,4 +191,18 @@ meow_error_t x86_pic_set_mask(uint16_t mask) {
     x86_outb(PIC2_DATA, (mask >> 8) & 0xFF);
     
     return MEOW_SUCCESS;
-}
\ No newline at end of file
+}
+
+/* ============================================================================
+ * IRQ ROUTING
+ * ============================================================================ */
+
+/* Unmask an ISA IRQ on whichever controller is active */
+meow_error_t x86_irq_unmask(uint8_t irq) {
+    return x86_apic_is_enabled() ? x86_ioapic_enable_irq(irq) : x86_pic_enable_irq(irq);
+}
+
+/* Mask an ISA IRQ on whichever controller is active */
+meow_error_t x86_irq_mask(uint8_t irq) {
+    return x86_apic_is_enabled() ? x86_ioapic_disable_irq(irq) : x86_pic_disable_irq(irq);
+}
@@ -112,6 +112,11 @@ meow_error_t x86_idt_init(void) {
     return MEOW_SUCCESS;
 }
 
+/* Load the shared IDT on an application processor */
+void x86_idt_load(void) {
+    x86_idt_flush((uint32_t)&idt_ptr);
+}
+
 /* Set a specific IDT gate (for external use) */
 meow_error_t x86_idt_set_gate(uint8_t num, uint32_t base, uint16_t selector, uint8_t flags) {
     idt_set_gate(num, base, selector, flags);
@@ -166,25 +171,8 @@ void x86_idt_handle_interrupt(x86_cpu_state_t* state) {
             x86_hlt();
         }
     } else if (interrupt_number >= 32 && interrupt_number <= 47) {
-        /* Hardware IRQ */
-        uint8_t irq = interrupt_number - 32;
-        
-        switch (irq) {
-            case 0:
-                /* Timer IRQ */
-                meow_log(MEOW_LOG_PURR, "Timer IRQ received");
-                break;
-            case 1:
-                /* Keyboard IRQ */
-                meow_log(MEOW_LOG_PURR, "Keyboard IRQ received");
-                break;
-            default:
-                meow_log(MEOW_LOG_PURR, "Hardware IRQ %u received", irq);
-                break;
-        }
-        
-        /* Send EOI to PIC */
-        x86_pic_eoi(irq);
+        /* Hardware IRQs never get here: interrupt_common_stub dispatches
+         * them through x86_irq_handlers[] itself */
     } else {
         /* Unknown interrupt */
         meow_log(MEOW_LOG_HISS, "Unknown interrupt: %u", interrupt_number);
@@ -7,6 +7,9 @@
 #include "x86_meow_hal_interface.h"
 #include "../meow_hal_interface.h"
 #include "../../kernel/meow_util.h"
+#include "../../kernel/meow_lock.h"
+#include "../../kernel/meow_percpu.h"
+#include "../../kernel/meow_trace.h"
 
 /* ============================================================================
  * X86 HAL STATE AND GLOBALS
@@ -22,10 +25,28 @@ static multiboot_info_t* x86_multiboot_info = NULL;
 static uint32_t x86_detected_memory = 0;
 static uint32_t x86_available_memory = 0;
 static uint32_t x86_timer_frequency = 0;
+static void (*x86_timer_callback)(void) = NULL;
 static uint64_t x86_timer_ticks = 0;
 
-/* Interrupt handler table */
-static void (*x86_irq_handlers[MEOW_HAL_MAX_IRQ_HANDLERS])(uint8_t irq) = {0};
+/* Interrupt dispatch state, read directly by interrupt_common_stub */
+x86_irq_handler_t x86_irq_handlers[MEOW_HAL_MAX_IRQ_HANDLERS] = {0};
+MEOW_DEFINE_PER_CPU(uint32_t, x86_irq_counts[MEOW_HAL_MAX_IRQ_HANDLERS]) = {0};
+void (*x86_irq_eoi)(uint8_t irq) = x86_pic_eoi;
+void (*x86_irq_exit_hook)(void) = NULL;
+
+#if MEOW_TRACING
+static void x86_irq_trace(uint8_t irq) {
+    MEOW_TRACE("irq: %u", irq);
+}
+void (*x86_irq_trace_hook)(uint8_t irq) = x86_irq_trace;
+#else
+void (*x86_irq_trace_hook)(uint8_t irq) = NULL;
+#endif
+
+/* Serialises handler updates; the dispatch path reads each slot with a
+ * single aligned load and takes no lock */
+MEOW_LOCK_CLASS(x86_irq_lock_class, "x86-irq-handlers");
+static meow_spinlock_t x86_irq_handlers_lock = MEOW_SPINLOCK_INIT(&x86_irq_lock_class);
 
 /* ============================================================================
  * X86 CPU OPERATIONS IMPLEMENTATION
@@ -144,13 +165,15 @@ static const char* x86_cpu_get_vendor_impl(void) {
 }
 
 static uint32_t x86_cpu_get_frequency_impl(void) {
-    /* TODO: Implement CPU frequency detection */
-    return 0; /* Unknown frequency */
+    /* Calibrated against the PIT when the timer came up */
+    return x86_tsc_get_khz();
 }
 
 static meow_error_t x86_cpu_enter_sleep_impl(uint8_t sleep_level) {
     (void)sleep_level;
-    x86_hlt();
+    /* sti only takes effect after the next instruction, so no interrupt
+     * can slip in between and leave hlt waiting for one that already came */
+    asm volatile("sti; hlt" ::: "memory");
     return MEOW_SUCCESS;
 }
 
@@ -159,6 +182,26 @@ static meow_error_t x86_cpu_exit_sleep_impl(void) {
     return MEOW_SUCCESS;
 }
 
+static meow_error_t x86_cpu_set_percpu_offset_impl(uint32_t cpu, uintptr_t offset) {
+    return x86_gdt_set_percpu_base(cpu, (uint32_t)offset);
+}
+
+/* First switch to a new thread pops zeroed callee-saved registers and
+ * returns into entry, which finds arg where a caller would put it */
+static void* x86_cpu_init_context_impl(void* stack_top, void (*entry)(void* arg), void* arg) {
+    /* arg sits 16-byte aligned, as after a normal call */
+    uint32_t* sp = (uint32_t*)(((uint32_t)stack_top & ~0xFu) - 16);
+    
+    sp[0] = (uint32_t)arg;
+    *--sp = 0;                  /* Return address of entry; it never returns */
+    *--sp = (uint32_t)entry;
+    *--sp = 0;                  /* ebp */
+    *--sp = 0;                  /* ebx */
+    *--sp = 0;                  /* esi */
+    *--sp = 0;                  /* edi */
+    return sp;
+}
+
 /* ============================================================================
  * X86 MEMORY OPERATIONS IMPLEMENTATION
  * ============================================================================ */
@@ -210,25 +253,34 @@ static void* x86_memory_get_kernel_end_impl(void) {
     return &_kernel_end;
 }
 
+/* Translate MEOW_PAGE_* flags into x86 page table entry bits */
+static uint32_t x86_page_flags_from_hal(uint32_t flags) {
+    uint32_t pte = 0;
+    if (flags & MEOW_PAGE_PRESENT)  pte |= X86_PTE_PRESENT;
+    if (flags & MEOW_PAGE_WRITABLE) pte |= X86_PTE_WRITABLE;
+    if (flags & MEOW_PAGE_USER)     pte |= X86_PTE_USER;
+    if (flags & MEOW_PAGE_NOCACHE)  pte |= X86_PTE_CACHE_DISABLE | X86_PTE_WRITE_THROUGH;
+    if (flags & MEOW_PAGE_GLOBAL)   pte |= X86_PTE_GLOBAL;
+    return pte;
+}
+
+static meow_error_t x86_memory_init_paging_impl(void) {
+    MEOW_RETURN_IF_ERROR(x86_paging_init());
+    MEOW_RETURN_IF_ERROR(x86_apic_map_mmio());
+    return x86_paging_enable();
+}
+
 static meow_error_t x86_memory_map_page_impl(void* virtual_addr, void* physical_addr, uint32_t flags) {
-    /* TODO: Implement page mapping for x86 MMU */
-    (void)virtual_addr;
-    (void)physical_addr;
-    (void)flags;
-    return MEOW_ERROR_NOT_SUPPORTED;
+    return x86_paging_map_page((uint32_t)virtual_addr, (uint32_t)physical_addr,
+                               x86_page_flags_from_hal(flags));
 }
 
 static meow_error_t x86_memory_unmap_page_impl(void* virtual_addr) {
-    /* TODO: Implement page unmapping */
-    (void)virtual_addr;
-    return MEOW_ERROR_NOT_SUPPORTED;
+    return x86_paging_unmap_page((uint32_t)virtual_addr);
 }
 
 static meow_error_t x86_memory_set_page_flags_impl(void* virtual_addr, uint32_t flags) {
-    /* TODO: Implement page flag setting */
-    (void)virtual_addr;
-    (void)flags;
-    return MEOW_ERROR_NOT_SUPPORTED;
+    return x86_paging_set_page_flags((uint32_t)virtual_addr, x86_page_flags_from_hal(flags));
 }
 
 static meow_error_t x86_memory_validate_pointer_impl(const void* ptr) {
@@ -292,8 +344,14 @@ static meow_error_t x86_interrupt_init_impl(void) {
     
     meow_log(MEOW_LOG_CHIRP,"==== x86: Initializing interrupt subsystem... ====");
     
-    /* Clear interrupt handler table */
+    /* Clear interrupt handler table and counters */
     meow_memset(x86_irq_handlers, 0, sizeof(x86_irq_handlers));
+    meow_memset(x86_irq_counts, 0, sizeof(x86_irq_counts));
+    
+    /* Prefer the APIC; the 8259 PIC set up in cpu init stays as fallback */
+    if (x86_apic_init() != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_MEOW, "x86: No APIC available, using the 8259 PIC");
+    }
     
     x86_interrupt_initialized = 1;
     return MEOW_SUCCESS;
@@ -329,11 +387,14 @@ static meow_error_t x86_interrupt_register_handler_impl(unsigned int irq, void (
         return MEOW_ERROR_NULL_POINTER;
     }
     
-    if (x86_irq_handlers[irq] != NULL) {
-        meow_log(MEOW_LOG_HISS,"  x86: Overwriting existing handler for IRQ %u", irq);
-    }
-    
+    uint32_t flags = meow_spin_lock_irqsave(&x86_irq_handlers_lock);
+    uint8_t overwrote = x86_irq_handlers[irq] != NULL;
     x86_irq_handlers[irq] = handler;
+    meow_spin_unlock_irqrestore(&x86_irq_handlers_lock, flags);
+
+    if (overwrote) {
+        meow_log(MEOW_LOG_HISS,"  x86: Overwrote existing handler for IRQ %u", irq);
+    }
     meow_log(MEOW_LOG_MEOW," x86: Registered handler for IRQ %u", irq);
     
     return MEOW_SUCCESS;
@@ -348,18 +409,22 @@ static meow_error_t x86_interrupt_unregister_handler_impl(unsigned int irq) {
         return MEOW_ERROR_INVALID_PARAMETER;
     }
     
+    uint32_t flags = meow_spin_lock_irqsave(&x86_irq_handlers_lock);
     x86_irq_handlers[irq] = NULL;
+    meow_spin_unlock_irqrestore(&x86_irq_handlers_lock, flags);
     meow_log(MEOW_LOG_MEOW," x86: Unregistered handler for IRQ %u", irq);
     
     return MEOW_SUCCESS;
 }
 
 static void x86_interrupt_handler_stub_impl(unsigned int irq) {
-    /* This function is called from assembly interrupt stubs */
-    if (irq < MEOW_HAL_MAX_IRQ_HANDLERS && x86_irq_handlers[irq]) {
-        x86_irq_handlers[irq](irq);
-    } else {
-        meow_log(MEOW_LOG_MEOW," x86: Unhandled IRQ %u", irq);
+    /* C twin of interrupt_common_stub for software-raised IRQs; no EOI */
+    if (irq >= MEOW_HAL_MAX_IRQ_HANDLERS) {
+        return;
+    }
+    (*this_cpu_ptr(&x86_irq_counts[irq]))++;
+    if (x86_irq_handlers[irq]) {
+        x86_irq_handlers[irq]((uint8_t)irq);
     }
 }
 
@@ -368,7 +433,7 @@ static meow_error_t x86_interrupt_enable_irq_impl(uint8_t irq) {
         return MEOW_ERROR_NOT_INITIALIZED;
     }
     
-    return x86_pic_enable_irq(irq);
+    return x86_irq_unmask(irq);
 }
 
 static meow_error_t x86_interrupt_disable_irq_impl(uint8_t irq) {
@@ -376,11 +441,11 @@ static meow_error_t x86_interrupt_disable_irq_impl(uint8_t irq) {
         return MEOW_ERROR_NOT_INITIALIZED;
     }
     
-    return x86_pic_disable_irq(irq);
+    return x86_irq_mask(irq);
 }
 
 static meow_error_t x86_interrupt_ack_irq_impl(uint8_t irq) {
-    x86_pic_eoi(irq);
+    x86_irq_eoi(irq);
     return MEOW_SUCCESS;
 }
 
@@ -389,16 +454,49 @@ static uint8_t x86_interrupt_get_current_irq_impl(void) {
     return MEOW_HAL_INVALID_IRQ;
 }
 
+/* Summed over every CPU that is online */
 static uint32_t x86_interrupt_get_irq_count_impl(uint8_t irq) {
-    /* TODO: Implement IRQ counting */
-    (void)irq;
-    return 0;
+    uint32_t count = 0;
+
+    for (uint32_t cpu = 0; cpu < x86_smp_get_cpu_count(); cpu++) {
+        count += *per_cpu_ptr(&x86_irq_counts[irq], cpu);
+    }
+    return count;
+}
+
+static meow_error_t x86_interrupt_set_exit_hook_impl(void (*hook)(void)) {
+    x86_irq_exit_hook = hook;
+    return MEOW_SUCCESS;
 }
 
 /* ============================================================================
  * X86 TIMER OPERATIONS IMPLEMENTATION
  * ============================================================================ */
 
+/* Timer callback (called from interrupt handler) */
+void x86_timer_tick(void) {
+    x86_timer_ticks++;
+    x86_pit_tick();
+    
+    if (x86_timer_callback) {
+        x86_timer_callback();
+    }
+}
+
+static void x86_timer_irq_handler(uint8_t irq) {
+    (void)irq;
+    x86_timer_tick();
+}
+
+/* Local APIC timer of a secondary CPU. The PIT keeps the tick count and
+ * the clock on the boot CPU; this only drives the kernel's callback. */
+static void x86_apic_timer_irq_handler(uint8_t irq) {
+    (void)irq;
+    if (x86_timer_callback) {
+        x86_timer_callback();
+    }
+}
+
 static meow_error_t x86_timer_init_impl(uint32_t frequency) {
     if (x86_timer_initialized) {
         return MEOW_ERROR_ALREADY_INITIALIZED;
@@ -408,8 +506,18 @@ static meow_error_t x86_timer_init_impl(uint32_t frequency) {
     
     MEOW_RETURN_IF_ERROR(x86_pit_init(frequency));
     
+    /* Not fatal: without a usable TSC the PIT ticks are the clocksource */
+    x86_tsc_init();
+    
+    /* Measured against the TSC, for the other CPUs' ticks */
+    if (x86_apic_is_enabled() && x86_apic_timer_calibrate(frequency) != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_HISS, "x86: LAPIC timer calibration failed, other CPUs get no tick");
+    }
+    
     x86_timer_frequency = frequency;
     x86_timer_ticks = 0;
+    x86_irq_handlers[0] = x86_timer_irq_handler;
+    x86_irq_handlers[X86_APIC_TIMER_IRQ] = x86_apic_timer_irq_handler;
     x86_timer_initialized = 1;
     
     return MEOW_SUCCESS;
@@ -423,7 +531,7 @@ static meow_error_t x86_timer_shutdown_impl(void) {
     meow_log(MEOW_LOG_CHIRP,"==== x86: Shutting down timer subsystem... ====");
     
     /* Disable timer IRQ */
-    x86_pic_disable_irq(0);
+    x86_irq_mask(0);
     
     x86_timer_initialized = 0;
     return MEOW_SUCCESS;
@@ -435,7 +543,7 @@ static meow_error_t x86_timer_start_impl(void) {
     }
     
     /* Enable timer IRQ */
-    return x86_pic_enable_irq(0);
+    return x86_irq_unmask(0);
 }
 
 static meow_error_t x86_timer_stop_impl(void) {
@@ -444,7 +552,7 @@ static meow_error_t x86_timer_stop_impl(void) {
     }
     
     /* Disable timer IRQ */
-    return x86_pic_disable_irq(0);
+    return x86_irq_mask(0);
 }
 
 static meow_error_t x86_timer_set_frequency_impl(uint32_t frequency) {
@@ -466,12 +574,26 @@ static uint64_t x86_timer_get_ticks_impl(void) {
     return x86_timer_ticks;
 }
 
+static uint64_t x86_timer_get_ns_impl(void) {
+    if (x86_tsc_is_reliable()) {
+        return x86_tsc_get_ns();
+    }
+    if (x86_timer_frequency == 0) {
+        return 0;
+    }
+    
+    return x86_pit_get_ns();
+}
+
 static uint64_t x86_timer_get_milliseconds_impl(void) {
+    if (x86_tsc_is_reliable()) {
+        return x86_tsc_get_ns() / 1000000;
+    }
     if (x86_timer_frequency == 0) {
         return 0;
     }
     
-    return (x86_timer_ticks * 1000) / x86_timer_frequency;
+    return x86_pit_get_ns() / 1000000;
 }
 
 static meow_error_t x86_timer_sleep_impl(uint32_t milliseconds) {
@@ -489,22 +611,45 @@ static meow_error_t x86_timer_sleep_impl(uint32_t milliseconds) {
     return MEOW_SUCCESS;
 }
 
-/* Timer callback (called from interrupt handler) */
-void x86_timer_tick(void) {
-    x86_timer_ticks++;
+static meow_error_t x86_timer_set_oneshot_impl(uint64_t delta_ns) {
+    if (!x86_timer_initialized) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+    
+    return x86_pit_set_oneshot(delta_ns);
+}
+
+static meow_error_t x86_timer_set_periodic_impl(void) {
+    if (!x86_timer_initialized) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+    
+    return x86_pit_set_periodic();
+}
+
+static meow_error_t x86_timer_start_local_impl(void) {
+    if (!x86_timer_initialized) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
     
-    /* TODO: Call registered timer callbacks */
+    return x86_apic_timer_start();
 }
 
 static meow_error_t x86_timer_register_callback_impl(void (*callback)(void)) {
-    /* TODO: Implement timer callbacks */
-    (void)callback;
-    return MEOW_ERROR_NOT_SUPPORTED;
+    if (!callback) {
+        return MEOW_ERROR_NULL_POINTER;
+    }
+    if (x86_timer_callback) {
+        return MEOW_ERROR_DEVICE_BUSY;
+    }
+    
+    x86_timer_callback = callback;
+    return MEOW_SUCCESS;
 }
 
 static meow_error_t x86_timer_unregister_callback_impl(void) {
-    /* TODO: Implement timer callback removal */
-    return MEOW_ERROR_NOT_SUPPORTED;
+    x86_timer_callback = NULL;
+    return MEOW_SUCCESS;
 }
 
 /* ============================================================================
@@ -587,13 +732,33 @@ static meow_error_t x86_io_write64_impl(void* addr, uint64_t data) {
  * X86 DEBUG OPERATIONS IMPLEMENTATION
  * ============================================================================ */
 
+/* Serial console on COM1; needs the interrupt subsystem for its IRQ */
 static meow_error_t x86_debug_init_impl(void) {
-    /* VGA text mode is available by default on x86 */
+    if (!x86_interrupt_initialized) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+
+    meow_error_t result = x86_serial_init();
+    if (result != MEOW_SUCCESS) {
+        return result;
+    }
+
+    /* Polled output still works if the IRQ can't be had */
+    if (x86_interrupt_register_handler_impl(X86_SERIAL_COM1_IRQ, x86_serial_irq_handler) ==
+            MEOW_SUCCESS &&
+        x86_irq_unmask(X86_SERIAL_COM1_IRQ) == MEOW_SUCCESS) {
+        x86_serial_start_irq();
+    }
     return MEOW_SUCCESS;
 }
 
+/* Without a UART the output falls back to the VGA screen */
 static meow_error_t x86_debug_putc_impl(char c) {
-    x86_vga_putc(c);
+    if (x86_serial_is_present()) {
+        x86_serial_write(&c, 1);
+    } else {
+        x86_vga_putc(c);
+    }
     return MEOW_SUCCESS;
 }
 
@@ -603,10 +768,17 @@ static meow_error_t x86_debug_puts_impl(const char* str) {
     }
     
     size_t count = 0;
-    while (*str && count < MEOW_HAL_MAX_DEBUG_STRING_LEN) {
-        x86_vga_putc(*str++);
+    while (str[count] && count < MEOW_HAL_MAX_DEBUG_STRING_LEN) {
         count++;
     }
+
+    if (x86_serial_is_present()) {
+        x86_serial_write(str, count);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            x86_vga_putc(str[i]);
+        }
+    }
     
     return MEOW_SUCCESS;
 }
@@ -718,7 +890,14 @@ static const struct hal_cpu_ops x86_cpu_ops = {
     .get_cpu_vendor = x86_cpu_get_vendor_impl,
     .get_cpu_frequency = x86_cpu_get_frequency_impl,
     .enter_sleep = x86_cpu_enter_sleep_impl,
-    .exit_sleep = x86_cpu_exit_sleep_impl
+    .exit_sleep = x86_cpu_exit_sleep_impl,
+    .init_context = x86_cpu_init_context_impl,
+    .switch_context = x86_context_switch,
+    .start_secondary_cpus = x86_smp_start_aps,
+    .get_cpu_id = x86_smp_get_cpu_id,
+    .get_cpu_count = x86_smp_get_cpu_count,
+    .send_reschedule = x86_smp_send_reschedule,
+    .set_percpu_offset = x86_cpu_set_percpu_offset_impl
 };
 
 static const struct hal_memory_ops x86_memory_ops = {
@@ -726,6 +905,7 @@ static const struct hal_memory_ops x86_memory_ops = {
     .get_total_size = x86_memory_get_total_size_impl,
     .get_available_size = x86_memory_get_available_size_impl,
     .get_kernel_end = x86_memory_get_kernel_end_impl,
+    .init_paging = x86_memory_init_paging_impl,
     .map_page = x86_memory_map_page_impl,
     .unmap_page = x86_memory_unmap_page_impl,
     .set_page_flags = x86_memory_set_page_flags_impl,
@@ -745,7 +925,8 @@ static const struct hal_interrupt_ops x86_interrupt_ops = {
     .disable_irq = x86_interrupt_disable_irq_impl,
     .ack_irq = x86_interrupt_ack_irq_impl,
     .get_current_irq = x86_interrupt_get_current_irq_impl,
-    .get_irq_count = x86_interrupt_get_irq_count_impl
+    .get_irq_count = x86_interrupt_get_irq_count_impl,
+    .set_exit_hook = x86_interrupt_set_exit_hook_impl
 };
 
 static const struct hal_timer_ops x86_timer_ops = {
@@ -755,8 +936,12 @@ static const struct hal_timer_ops x86_timer_ops = {
     .stop = x86_timer_stop_impl,
     .set_frequency = x86_timer_set_frequency_impl,
     .get_frequency = x86_timer_get_frequency_impl,
+    .set_oneshot = x86_timer_set_oneshot_impl,
+    .set_periodic = x86_timer_set_periodic_impl,
+    .start_local = x86_timer_start_local_impl,
     .get_ticks = x86_timer_get_ticks_impl,
     .get_milliseconds = x86_timer_get_milliseconds_impl,
+    .get_ns = x86_timer_get_ns_impl,
     .sleep = x86_timer_sleep_impl,
     .register_callback = x86_timer_register_callback_impl,
     .unregister_callback = x86_timer_unregister_callback_impl
@@ -840,6 +1025,7 @@ static uint8_t x86_hal_is_initialized_impl(void) {
 
 static void x86_hal_emergency_halt_impl(const char* reason) {
     meow_log(MEOW_LOG_YOWL,"==== x86: EMERGENCY HALT - %s ====", reason ? reason : "Unknown");
+    x86_serial_flush();
     x86_cpu_ops.disable_interrupts();
     x86_cpu_ops.halt();
 }
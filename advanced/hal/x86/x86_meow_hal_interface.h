@@ -18,6 +18,27 @@
 #define X86_KERNEL_PHYSICAL_BASE    0x00100000  /* 1MB */
 #define X86_PAGE_SIZE               4096
 #define X86_PAGE_ALIGN_MASK         0xFFFFF000
+#define X86_LARGE_PAGE_SIZE         0x00400000  /* 4MB PSE page */
+#define X86_LARGE_PAGE_ALIGN_MASK   0xFFC00000
+#define X86_PAGE_TABLE_ENTRIES      1024
+
+/* x86 Page Directory / Page Table Entry Bits */
+#define X86_PTE_PRESENT             0x001
+#define X86_PTE_WRITABLE            0x002
+#define X86_PTE_USER                0x004
+#define X86_PTE_WRITE_THROUGH       0x008
+#define X86_PTE_CACHE_DISABLE       0x010
+#define X86_PTE_ACCESSED            0x020
+#define X86_PTE_DIRTY               0x040
+#define X86_PDE_LARGE               0x080       /* PDE maps a 4MB page (PSE) */
+#define X86_PTE_GLOBAL              0x100       /* Survives CR3 reloads (PGE) */
+#define X86_PTE_FLAGS_MASK          0xFFF
+
+/* x86 Control Register Bits */
+#define X86_CR0_WP                  0x00010000  /* Honour read-only pages in ring 0 */
+#define X86_CR0_PG                  0x80000000
+#define X86_CR4_PSE                 0x00000010
+#define X86_CR4_PGE                 0x00000080
 
 /* x86 GDT Constants */
 #define X86_GDT_ENTRIES             8
@@ -27,6 +48,8 @@
 #define X86_GDT_USER_CODE           0x18
 #define X86_GDT_USER_DATA           0x20
 #define X86_GDT_TSS_SELECTOR        0x28
+#define X86_GDT_PERCPU_INDEX        6
+#define X86_GDT_PERCPU_SELECTOR     0x30    /* %fs, based at this CPU's per-CPU offset */
 
 /* x86 IDT Constants */
 #define X86_IDT_ENTRIES             256
@@ -138,6 +161,16 @@ static inline void x86_nop(void) {
     asm volatile("nop");
 }
 
+/* Spin-wait hint */
+static inline void x86_pause(void) {
+    asm volatile("pause" ::: "memory");
+}
+
+/* Reload %fs, picking up a changed descriptor */
+static inline void x86_load_fs(uint16_t selector) {
+    asm volatile("movw %0, %%fs" :: "r"(selector) : "memory");
+}
+
 /* Control register access */
 static inline uint32_t x86_get_cr0(void) {
     uint32_t cr0;
@@ -165,6 +198,38 @@ static inline void x86_set_cr3(uint32_t cr3) {
     asm volatile("mov %0, %%cr3" :: "r"(cr3) : "memory");
 }
 
+static inline uint32_t x86_get_cr4(void) {
+    uint32_t cr4;
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    return cr4;
+}
+
+static inline void x86_set_cr4(uint32_t cr4) {
+    asm volatile("mov %0, %%cr4" :: "r"(cr4) : "memory");
+}
+
+static inline void x86_invlpg(uint32_t virtual_addr) {
+    asm volatile("invlpg (%0)" :: "r"(virtual_addr) : "memory");
+}
+
+/* Model specific registers */
+static inline uint64_t x86_rdmsr(uint32_t msr) {
+    uint32_t low, high;
+    asm volatile("rdmsr" : "=a"(low), "=d"(high) : "c"(msr));
+    return ((uint64_t)high << 32) | low;
+}
+
+static inline void x86_wrmsr(uint32_t msr, uint64_t value) {
+    asm volatile("wrmsr" :: "c"(msr), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+/* Time stamp counter */
+static inline uint64_t x86_rdtsc(void) {
+    uint32_t low, high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+}
+
 static inline uint32_t x86_get_eflags(void) {
     uint32_t eflags;
     asm volatile("pushfl; popl %0" : "=r"(eflags));
@@ -228,14 +293,18 @@ static inline void x86_memory_barrier_write(void) {
  * X86 SUBSYSTEM INITIALIZATION FUNCTIONS
  * ============================================================================ */
 
-/* GDT (Global Descriptor Table) management */
+/* GDT (Global Descriptor Table) management. Every CPU gets its own copy
+ * of the boot CPU's table, differing only in the per-CPU segment base. */
 meow_error_t x86_gdt_init(void);
+meow_error_t x86_gdt_load_cpu(uint32_t cpu);
+meow_error_t x86_gdt_set_percpu_base(uint32_t cpu, uint32_t base);
 meow_error_t x86_gdt_set_gate(uint32_t num, uint32_t base, uint32_t limit, 
                                uint8_t access, uint8_t granularity);
 uint32_t x86_gdt_get_selector(uint32_t index);
 
 /* IDT (Interrupt Descriptor Table) management */
 meow_error_t x86_idt_init(void);
+void x86_idt_load(void);
 meow_error_t x86_idt_set_gate(uint8_t num, uint32_t base, uint16_t selector, 
                                uint8_t flags);
 void x86_idt_handle_interrupt(x86_cpu_state_t* state);
@@ -250,11 +319,26 @@ meow_error_t x86_pic_disable_all_irqs(void);
 uint16_t x86_pic_get_mask(void);
 meow_error_t x86_pic_set_mask(uint16_t mask);
 
+/* IRQ line masking, routed to the I/O APIC or the PIC whichever is active */
+meow_error_t x86_irq_unmask(uint8_t irq);
+meow_error_t x86_irq_mask(uint8_t irq);
+
 /* PIT (Programmable Interval Timer) management */
 meow_error_t x86_pit_init(uint32_t frequency);
 meow_error_t x86_pit_set_frequency(uint32_t frequency);
 uint32_t x86_pit_get_frequency(void);
 meow_error_t x86_pit_set_mode(uint8_t channel, uint8_t mode);
+void x86_pit_tick(void);
+meow_error_t x86_pit_set_oneshot(uint64_t delta_ns);
+meow_error_t x86_pit_set_periodic(void);
+uint64_t x86_pit_get_ns(void);
+
+/* TSC clocksource, calibrated against PIT channel 2 */
+meow_error_t x86_tsc_init(void);
+uint8_t x86_tsc_is_reliable(void);
+uint32_t x86_tsc_get_khz(void);
+uint64_t x86_tsc_get_ns(void);
+void x86_delay_us(uint32_t microseconds);
 
 /* ============================================================================
  * X86 MEMORY MANAGEMENT FUNCTIONS
@@ -271,14 +355,122 @@ meow_error_t x86_physical_free_page(void* page);
 uint32_t x86_physical_get_total_pages(void);
 uint32_t x86_physical_get_free_pages(void);
 
-/* Virtual memory management (paging) */
+/* Virtual memory management (paging). Flags are X86_PTE_* bits. */
 meow_error_t x86_paging_init(void);
 meow_error_t x86_paging_enable(void);
 meow_error_t x86_paging_disable(void);
 meow_error_t x86_paging_map_page(uint32_t virtual_addr, uint32_t physical_addr, 
                                   uint32_t flags);
 meow_error_t x86_paging_unmap_page(uint32_t virtual_addr);
+meow_error_t x86_paging_set_page_flags(uint32_t virtual_addr, uint32_t flags);
 uint32_t x86_paging_get_physical_addr(uint32_t virtual_addr);
+uint32_t x86_paging_get_direct_map_end(void);
+
+/* ============================================================================
+ * X86 ACPI AND APIC
+ * ============================================================================ */
+
+#define X86_MAX_CPUS                16
+#define X86_MAX_IOAPICS             4
+#define X86_MAX_IRQ_OVERRIDES       16
+#define X86_ISA_IRQS                16
+#define X86_APIC_SPURIOUS_VECTOR    0xFF
+#define X86_APIC_TIMER_VECTOR       48          /* IRQ line 16, after the ISA IRQs */
+#define X86_APIC_RESCHEDULE_VECTOR  49          /* IRQ line 17 */
+#define X86_APIC_TIMER_IRQ          (X86_APIC_TIMER_VECTOR - 32)
+#define X86_APIC_RESCHEDULE_IRQ     (X86_APIC_RESCHEDULE_VECTOR - 32)
+
+/* MADT flags and interrupt source override (MPS INTI) flags */
+#define X86_MADT_PCAT_COMPAT        0x1         /* Dual 8259 PICs present */
+#define X86_MPS_POLARITY_MASK       0x3
+#define X86_MPS_POLARITY_LOW        0x3
+#define X86_MPS_TRIGGER_MASK        0xC
+#define X86_MPS_TRIGGER_LEVEL       0xC
+
+typedef struct x86_madt_ioapic {
+    uint8_t id;
+    uint32_t address;               /* Physical MMIO base */
+    uint32_t gsi_base;              /* First global system interrupt */
+} x86_madt_ioapic_t;
+
+typedef struct x86_madt_override {
+    uint8_t source_irq;             /* ISA IRQ */
+    uint32_t gsi;                   /* Global system interrupt it is wired to */
+    uint16_t flags;                 /* X86_MPS_* polarity and trigger */
+} x86_madt_override_t;
+
+/* What the ACPI MADT says about the interrupt hardware */
+typedef struct x86_madt_info {
+    uint32_t lapic_address;         /* Physical Local APIC base */
+    uint32_t flags;                 /* X86_MADT_* */
+    uint32_t cpu_count;             /* Enabled processors */
+    uint8_t cpu_apic_ids[X86_MAX_CPUS];
+    uint32_t ioapic_count;
+    x86_madt_ioapic_t ioapics[X86_MAX_IOAPICS];
+    uint32_t override_count;
+    x86_madt_override_t overrides[X86_MAX_IRQ_OVERRIDES];
+} x86_madt_info_t;
+
+/* ACPI table discovery */
+meow_error_t x86_acpi_init(void);
+const x86_madt_info_t* x86_acpi_get_madt(void);
+
+/* Interrupt command register, low dword */
+#define X86_ICR_FIXED               0x00000000
+#define X86_ICR_INIT                0x00000500
+#define X86_ICR_STARTUP             0x00000600
+#define X86_ICR_LEVEL_ASSERT        0x00004000
+
+/* Local APIC and I/O APIC */
+meow_error_t x86_apic_init(void);
+meow_error_t x86_apic_init_ap(void);
+meow_error_t x86_apic_map_mmio(void);
+uint8_t x86_apic_is_enabled(void);
+uint8_t x86_apic_get_id(void);
+void x86_apic_eoi(uint8_t irq);
+meow_error_t x86_apic_send_ipi(uint8_t apic_id, uint32_t icr_low);
+meow_error_t x86_ioapic_enable_irq(uint8_t irq);
+meow_error_t x86_ioapic_disable_irq(uint8_t irq);
+meow_error_t x86_ioapic_set_affinity(uint8_t irq, uint8_t apic_id);
+meow_error_t x86_apic_timer_calibrate(uint32_t frequency);
+meow_error_t x86_apic_timer_start(void);
+extern void x86_apic_spurious_stub(void);
+extern void x86_apic_timer_stub(void);
+extern void x86_apic_reschedule_stub(void);
+
+/* ============================================================================
+ * X86 SMP BRING-UP
+ * ============================================================================ */
+
+#define X86_SMP_TRAMPOLINE_ADDR     0x8000      /* Must match x86_smp_trampoline.S */
+#define X86_SMP_STACK_ORDER         2           /* 16KB, as for the boot CPU */
+
+/* Application processor startup; CPU 0 is the boot CPU */
+meow_error_t x86_smp_start_aps(void (*entry)(void));
+uint32_t x86_smp_get_cpu_id(void);
+uint32_t x86_smp_get_cpu_count(void);
+meow_error_t x86_smp_send_reschedule(uint32_t cpu);
+
+/* Real-mode startup code, copied below 1MB before use */
+extern const uint8_t x86_smp_trampoline_start[];
+extern const uint8_t x86_smp_trampoline_params[];
+extern const uint8_t x86_smp_trampoline_end[];
+
+/* ============================================================================
+ * X86 SERIAL PORT
+ * ============================================================================ */
+
+#define X86_SERIAL_COM1             0x3F8
+#define X86_SERIAL_COM1_IRQ         4
+#define X86_SERIAL_DIVISOR          1           /* 115200 baud */
+
+/* 16550 UART debug console with an interrupt-driven transmit ring */
+meow_error_t x86_serial_init(void);
+uint8_t x86_serial_is_present(void);
+void x86_serial_start_irq(void);
+void x86_serial_write(const char* data, size_t length);
+void x86_serial_irq_handler(uint8_t irq);
+void x86_serial_flush(void);
 
 /* ============================================================================
  * X86 CPU FEATURE DETECTION
@@ -316,6 +508,10 @@ uint32_t x86_get_cpu_extended_features(void);
 #define X86_FEATURE_SSE         (1 << 25)  /* SSE */
 #define X86_FEATURE_SSE2        (1 << 26)  /* SSE2 */
 
+/* Advanced power management (CPUID leaf 0x80000007, EDX) */
+#define X86_CPUID_EXT_POWER     0x80000007
+#define X86_FEATURE_INVARIANT_TSC (1 << 8) /* TSC rate ignores P/C-states */
+
 /* ============================================================================
  * X86 VGA TEXT MODE FUNCTIONS
  * ============================================================================ */
@@ -446,6 +642,17 @@ meow_error_t x86_test_timer(void);
 /* Timer tick callback (called from interrupt handler) */
 void x86_timer_tick(void);
 
+/* IRQ dispatch state, indexed by IRQ line straight from interrupt_common_stub */
+typedef void (*x86_irq_handler_t)(uint8_t irq);
+extern x86_irq_handler_t x86_irq_handlers[MEOW_HAL_MAX_IRQ_HANDLERS];
+extern uint32_t x86_irq_counts[MEOW_HAL_MAX_IRQ_HANDLERS];   /* Per-CPU */
+extern void (*x86_irq_eoi)(uint8_t irq);   /* Interrupt controller EOI */
+extern void (*x86_irq_exit_hook)(void);    /* After EOI, NULL when unused */
+extern void (*x86_irq_trace_hook)(uint8_t irq);    /* Before dispatch, NULL when unused */
+
+/* Kernel thread context switch (x86_context_switch.S) */
+void x86_context_switch(void** save_sp, void* next_sp);
+
 /* Common interrupt handler (called from assembly stubs) */
 void x86_common_interrupt_handler(x86_cpu_state_t* state);
 
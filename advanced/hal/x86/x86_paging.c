@@ -0,0 +1,281 @@
+/* advanced/hal/x86/x86_paging.c - Two-level i386 Paging
+ *
+ * Physical memory up to the end of the normal zone is identity mapped with
+ * 4MB PSE pages (global when PGE is available), so the kernel keeps using
+ * physical addresses as pointers and the whole direct map costs a handful
+ * of TLB entries. Everything else is mapped with 4KB pages whose tables
+ * come from the physical memory manager. A 4MB page is split into a 4KB
+ * table the first time part of it is remapped.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "x86_meow_hal_interface.h"
+#include "../../mm/meow_physical_memory.h"
+#include "../../kernel/meow_util.h"
+
+#define PD_INDEX(va) ((va) >> 22)
+#define PT_INDEX(va) (((va) >> 12) & (X86_PAGE_TABLE_ENTRIES - 1))
+
+/* Global paging state */
+static uint32_t* page_directory = NULL;
+static uint32_t direct_map_end = 0;
+static uint32_t global_flag = 0;         /* X86_PTE_GLOBAL when PGE is usable */
+static uint8_t has_pse = 0;
+static uint8_t has_pge = 0;
+static uint8_t paging_initialized = 0;
+static uint8_t paging_enabled = 0;
+
+/* ============================================================================
+ * INTERNAL HELPERS
+ * ============================================================================ */
+
+/* Get a zeroed page table from the PMM. It sits in the direct map, so its
+ * physical address is also its virtual address. */
+static uint32_t* alloc_table_internal(void) {
+    uint32_t table = purr_alloc_territory();
+    if (!table) {
+        return NULL;
+    }
+    meow_memset((void*)table, 0, X86_PAGE_SIZE);
+    return (uint32_t*)table;
+}
+
+static inline void flush_page_internal(uint32_t virtual_addr) {
+    if (paging_enabled) {
+        x86_invlpg(virtual_addr);
+    }
+}
+
+/* Replace a 4MB mapping by a table of 1024 equivalent 4KB mappings */
+static uint32_t* split_large_page_internal(uint32_t* pde) {
+    uint32_t* table = alloc_table_internal();
+    if (!table) {
+        return NULL;
+    }
+
+    uint32_t base = *pde & X86_LARGE_PAGE_ALIGN_MASK;
+    uint32_t flags = *pde & X86_PTE_FLAGS_MASK & ~X86_PDE_LARGE;
+    for (uint32_t i = 0; i < X86_PAGE_TABLE_ENTRIES; i++) {
+        table[i] = (base + i * X86_PAGE_SIZE) | flags;
+    }
+
+    *pde = (uint32_t)table | X86_PTE_PRESENT | X86_PTE_WRITABLE | (*pde & X86_PTE_USER);
+    /* One invlpg drops the TLB entry of the whole 4MB page, global or not */
+    flush_page_internal(base);
+    return table;
+}
+
+/* Find the page table covering virtual_addr, creating or splitting as asked */
+static uint32_t* get_table_internal(uint32_t virtual_addr, uint8_t create) {
+    uint32_t* pde = &page_directory[PD_INDEX(virtual_addr)];
+
+    if (!(*pde & X86_PTE_PRESENT)) {
+        if (!create) {
+            return NULL;
+        }
+        uint32_t* table = alloc_table_internal();
+        if (!table) {
+            return NULL;
+        }
+        *pde = (uint32_t)table | X86_PTE_PRESENT | X86_PTE_WRITABLE;
+        return table;
+    }
+
+    if (*pde & X86_PDE_LARGE) {
+        return split_large_page_internal(pde);
+    }
+    return (uint32_t*)(*pde & X86_PAGE_ALIGN_MASK);
+}
+
+/* ============================================================================
+ * PAGING SETUP
+ * ============================================================================ */
+
+/* Build the page directory with the direct map */
+meow_error_t x86_paging_init(void) {
+    if (paging_initialized) {
+        return MEOW_ERROR_ALREADY_INITIALIZED;
+    }
+    if (!is_purr_memory_initialized()) {
+        meow_log(MEOW_LOG_YOWL, "x86: Paging needs the PMM for its tables");
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+
+    if (x86_cpuid_supported()) {
+        uint32_t eax, ebx, ecx, edx;
+        x86_cpuid(1, &eax, &ebx, &ecx, &edx);
+        has_pse = (edx & X86_FEATURE_PSE) != 0;
+        has_pge = (edx & X86_FEATURE_PGE) != 0;
+    }
+    global_flag = has_pge ? X86_PTE_GLOBAL : 0;
+
+    page_directory = alloc_table_internal();
+    if (!page_directory) {
+        meow_log(MEOW_LOG_YOWL, "x86: No territory for the page directory");
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Direct map all RAM below the high zone, rounded up to whole 4MB pages */
+    uint64_t ram_end = (uint64_t)get_total_territories() * TERRITORY_SIZE;
+    ram_end = (ram_end + X86_LARGE_PAGE_SIZE - 1) & ~(uint64_t)(X86_LARGE_PAGE_SIZE - 1);
+    direct_map_end = ram_end < PURR_ZONE_NORMAL_LIMIT ? (uint32_t)ram_end : PURR_ZONE_NORMAL_LIMIT;
+
+    uint32_t tables = 0;
+    for (uint32_t base = 0; base < direct_map_end; base += X86_LARGE_PAGE_SIZE) {
+        uint32_t flags = X86_PTE_PRESENT | X86_PTE_WRITABLE | global_flag;
+
+        if (has_pse) {
+            page_directory[PD_INDEX(base)] = base | flags | X86_PDE_LARGE;
+            continue;
+        }
+
+        uint32_t* table = alloc_table_internal();
+        if (!table) {
+            meow_log(MEOW_LOG_YOWL, "x86: Out of territories building the direct map");
+            return MEOW_ERROR_OUT_OF_MEMORY;
+        }
+        for (uint32_t i = 0; i < X86_PAGE_TABLE_ENTRIES; i++) {
+            table[i] = (base + i * X86_PAGE_SIZE) | flags;
+        }
+        page_directory[PD_INDEX(base)] = (uint32_t)table | X86_PTE_PRESENT | X86_PTE_WRITABLE;
+        tables++;
+    }
+
+    meow_log(MEOW_LOG_CHIRP, "x86: Direct map 0x0 - 0x%x with %s pages%s (%u tables)",
+             direct_map_end, has_pse ? "4MB" : "4KB", has_pge ? ", global" : "", tables);
+    paging_initialized = 1;
+    return MEOW_SUCCESS;
+}
+
+/* Load the page directory and turn paging on */
+meow_error_t x86_paging_enable(void) {
+    if (!paging_initialized) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+
+    uint32_t cr4 = x86_get_cr4();
+    if (has_pse) cr4 |= X86_CR4_PSE;
+    if (has_pge) cr4 |= X86_CR4_PGE;
+    x86_set_cr4(cr4);
+
+    x86_set_cr3((uint32_t)page_directory);
+    x86_set_cr0(x86_get_cr0() | X86_CR0_PG | X86_CR0_WP);
+    paging_enabled = 1;
+
+    meow_log(MEOW_LOG_CHIRP, "x86: Paging enabled (CR3: 0x%08x)", (uint32_t)page_directory);
+    return MEOW_SUCCESS;
+}
+
+/* Turn paging off; the tables are kept for a later enable */
+meow_error_t x86_paging_disable(void) {
+    if (!paging_enabled) {
+        return MEOW_ERROR_INVALID_STATE;
+    }
+    x86_set_cr0(x86_get_cr0() & ~X86_CR0_PG);
+    paging_enabled = 0;
+    return MEOW_SUCCESS;
+}
+
+/* ============================================================================
+ * PAGE MAPPING
+ * ============================================================================ */
+
+/* Map one 4KB page, replacing whatever mapped it before */
+meow_error_t x86_paging_map_page(uint32_t virtual_addr, uint32_t physical_addr,
+                                  uint32_t flags) {
+    if (!paging_initialized) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+    if ((virtual_addr | physical_addr) & (X86_PAGE_SIZE - 1)) {
+        return MEOW_ERROR_INVALID_ALIGNMENT;
+    }
+
+    uint32_t* table = get_table_internal(virtual_addr, 1);
+    if (!table) {
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (flags & X86_PTE_USER) {
+        page_directory[PD_INDEX(virtual_addr)] |= X86_PTE_USER;
+    }
+    table[PT_INDEX(virtual_addr)] = physical_addr | (flags & X86_PTE_FLAGS_MASK & ~X86_PDE_LARGE) |
+                                    X86_PTE_PRESENT;
+    flush_page_internal(virtual_addr);
+    return MEOW_SUCCESS;
+}
+
+/* Remove the mapping of one 4KB page */
+meow_error_t x86_paging_unmap_page(uint32_t virtual_addr) {
+    if (!paging_initialized) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+    if (!(page_directory[PD_INDEX(virtual_addr)] & X86_PTE_PRESENT)) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    uint32_t* table = get_table_internal(virtual_addr, 0);
+    if (!table) {
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+    if (!(table[PT_INDEX(virtual_addr)] & X86_PTE_PRESENT)) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    table[PT_INDEX(virtual_addr)] = 0;
+    flush_page_internal(virtual_addr);
+    return MEOW_SUCCESS;
+}
+
+/* Change the flags of one mapped 4KB page */
+meow_error_t x86_paging_set_page_flags(uint32_t virtual_addr, uint32_t flags) {
+    if (!paging_initialized) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+    if (!(page_directory[PD_INDEX(virtual_addr)] & X86_PTE_PRESENT)) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    uint32_t* table = get_table_internal(virtual_addr, 0);
+    if (!table) {
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+    uint32_t* pte = &table[PT_INDEX(virtual_addr)];
+    if (!(*pte & X86_PTE_PRESENT)) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    if (flags & X86_PTE_USER) {
+        page_directory[PD_INDEX(virtual_addr)] |= X86_PTE_USER;
+    }
+    *pte = (*pte & X86_PAGE_ALIGN_MASK) | (flags & X86_PTE_FLAGS_MASK & ~X86_PDE_LARGE) |
+           X86_PTE_PRESENT;
+    flush_page_internal(virtual_addr);
+    return MEOW_SUCCESS;
+}
+
+/* Translate a virtual address, 0 if it is not mapped */
+uint32_t x86_paging_get_physical_addr(uint32_t virtual_addr) {
+    if (!paging_initialized) {
+        return virtual_addr;
+    }
+
+    uint32_t pde = page_directory[PD_INDEX(virtual_addr)];
+    if (!(pde & X86_PTE_PRESENT)) {
+        return 0;
+    }
+    if (pde & X86_PDE_LARGE) {
+        return (pde & X86_LARGE_PAGE_ALIGN_MASK) | (virtual_addr & ~X86_LARGE_PAGE_ALIGN_MASK);
+    }
+
+    uint32_t pte = ((uint32_t*)(pde & X86_PAGE_ALIGN_MASK))[PT_INDEX(virtual_addr)];
+    if (!(pte & X86_PTE_PRESENT)) {
+        return 0;
+    }
+    return (pte & X86_PAGE_ALIGN_MASK) | (virtual_addr & (X86_PAGE_SIZE - 1));
+}
+
+/* End of the identity mapped physical memory */
+uint32_t x86_paging_get_direct_map_end(void) {
+    return direct_map_end;
+}
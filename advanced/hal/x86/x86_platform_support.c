@@ -133,11 +133,21 @@ const char* x86_get_cpu_vendor(void) {
  * VGA TEXT OUTPUT FUNCTIONS
  * ============================================================================ */
 
+/* Character offset the CRTC currently starts the screen at */
+static uint16_t x86_vga_start_offset(void) {
+    x86_outb(MEOW_VGA_CRTC_INDEX, MEOW_VGA_CRTC_START_HIGH);
+    uint16_t offset = (uint16_t)x86_inb(MEOW_VGA_CRTC_DATA) << 8;
+    x86_outb(MEOW_VGA_CRTC_INDEX, MEOW_VGA_CRTC_START_LOW);
+    return offset | x86_inb(MEOW_VGA_CRTC_DATA);
+}
+
 /**
  * x86_vga_putc - Put character to VGA text mode display
+ *
+ * Draws on whatever part of VRAM the kernel console has scrolled to.
  */
 void x86_vga_putc(char c) {
-    static uint16_t* vga_buffer = (uint16_t*)0xB8000;
+    uint16_t* vga_buffer = (uint16_t*)X86_VGA_MEMORY + x86_vga_start_offset();
     static uint8_t cursor_x = 0;
     static uint8_t cursor_y = 0;
     static uint8_t color = 0x07; /* Light gray on black */
@@ -210,21 +220,6 @@ meow_error_t x86_pit_set_frequency(uint32_t frequency) {
     return MEOW_SUCCESS;
 }
 
-/* ============================================================================
- * INTERRUPT HANDLING
- * ============================================================================ */
-
-/**
- * interrupt_handler - C interrupt handler called from assembly
- */
-void interrupt_handler(void) {
-    /* Simple interrupt handler - just acknowledge for now */
-    meow_log(MEOW_LOG_PURR, "x86: Interrupt received");
-    
-    /* Send EOI to PIC for hardware interrupts */
-    x86_outb(0x20, 0x20); /* EOI to master PIC */
-}
-
 /* ============================================================================
  * STUB FUNCTIONS FOR COMPATIBILITY
  * ============================================================================ */
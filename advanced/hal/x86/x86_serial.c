@@ -0,0 +1,216 @@
+/* advanced/hal/x86/x86_serial.c - 16550 UART on COM1
+ *
+ * The debug console. Writers copy bytes into a transmit ring and return;
+ * the THR-empty interrupt moves them to the UART 16 at a time through
+ * the FIFO. Until the interrupt is wired up, and whenever the ring is
+ * full, the writer pushes bytes out itself by polling, so nothing is
+ * dropped and early boot output is never stuck in the ring.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "x86_meow_hal_interface.h"
+#include "../../kernel/meow_util.h"
+#include "../../kernel/meow_lock.h"
+
+/* Register offsets from the base port */
+#define SERIAL_THR               0  /* Transmit holding (DLAB=0, write) */
+#define SERIAL_DLL               0  /* Divisor low (DLAB=1) */
+#define SERIAL_IER               1  /* Interrupt enable (DLAB=0) */
+#define SERIAL_DLM               1  /* Divisor high (DLAB=1) */
+#define SERIAL_IIR               2  /* Interrupt identification (read) */
+#define SERIAL_FCR               2  /* FIFO control (write) */
+#define SERIAL_LCR               3
+#define SERIAL_MCR               4
+#define SERIAL_LSR               5
+#define SERIAL_SCR               7
+
+#define SERIAL_IER_THRE          0x02
+#define SERIAL_IIR_NONE          0x01   /* No interrupt pending */
+#define SERIAL_IIR_ID_MASK       0x0E
+#define SERIAL_IIR_THRE          0x02
+#define SERIAL_FCR_ENABLE        0xC7   /* Enable, clear both FIFOs, 14-byte RX trigger */
+#define SERIAL_LCR_8N1           0x03
+#define SERIAL_LCR_DLAB          0x80
+#define SERIAL_MCR_RUN           0x0B   /* DTR, RTS, OUT2 (gates the IRQ line) */
+#define SERIAL_MCR_LOOPBACK      0x1E
+#define SERIAL_LSR_THRE          0x20
+#define SERIAL_PROBE_BYTE        0xAE
+
+#define SERIAL_FIFO_SIZE         16     /* Bytes the THR takes once empty */
+#define SERIAL_POLLS             100000 /* THRE polls before giving up on a byte */
+#define SERIAL_RING_SIZE         16384  /* Power of two */
+#define SERIAL_RING_MASK         (SERIAL_RING_SIZE - 1)
+
+/* Transmit ring: head is written by callers, tail by whoever drains */
+static char serial_ring[SERIAL_RING_SIZE];
+static uint32_t serial_head = 0;
+static uint32_t serial_tail = 0;
+
+/* Global serial state */
+MEOW_LOCK_CLASS(serial_lock_class, "serial-tx");
+static meow_spinlock_t serial_lock = MEOW_SPINLOCK_INIT(&serial_lock_class);
+static uint8_t serial_present = 0;
+static uint8_t serial_irq_driven = 0;
+static uint8_t serial_tx_active = 0;    /* THRE interrupt enabled */
+
+/* ============================================================================
+ * RING HELPERS (serial_lock held)
+ * ============================================================================ */
+
+static inline uint8_t serial_thr_empty_internal(void) {
+    return (x86_inb(X86_SERIAL_COM1 + SERIAL_LSR) & SERIAL_LSR_THRE) != 0;
+}
+
+/* Move up to a FIFO's worth of bytes; the THR must be empty */
+static void serial_fill_fifo_internal(void) {
+    for (uint32_t i = 0; i < SERIAL_FIFO_SIZE && serial_tail != serial_head; i++) {
+        x86_outb(X86_SERIAL_COM1 + SERIAL_THR, serial_ring[serial_tail & SERIAL_RING_MASK]);
+        serial_tail++;
+    }
+}
+
+/* Push one FIFO's worth out by polling; a dead UART loses the bytes */
+static void serial_poll_out_internal(void) {
+    uint32_t polls = 0;
+
+    while (!serial_thr_empty_internal() && polls < SERIAL_POLLS) {
+        meow_cpu_relax();
+        polls++;
+    }
+    if (polls == SERIAL_POLLS) {
+        uint32_t pending = serial_head - serial_tail;
+        serial_tail += pending < SERIAL_FIFO_SIZE ? pending : SERIAL_FIFO_SIZE;
+        return;
+    }
+    serial_fill_fifo_internal();
+}
+
+static void serial_enqueue_internal(char c) {
+    while (serial_head - serial_tail == SERIAL_RING_SIZE) {
+        serial_poll_out_internal();
+    }
+    serial_ring[serial_head & SERIAL_RING_MASK] = c;
+    serial_head++;
+}
+
+/* ============================================================================
+ * SERIAL INTERFACE
+ * ============================================================================ */
+
+meow_error_t x86_serial_init(void) {
+    uint16_t port = X86_SERIAL_COM1;
+
+    if (serial_present) {
+        return MEOW_ERROR_ALREADY_INITIALIZED;
+    }
+
+    /* Nothing decodes the port if the scratch register doesn't hold a value */
+    x86_outb(port + SERIAL_SCR, SERIAL_PROBE_BYTE);
+    if (x86_inb(port + SERIAL_SCR) != SERIAL_PROBE_BYTE) {
+        return MEOW_ERROR_DEVICE_NOT_FOUND;
+    }
+
+    x86_outb(port + SERIAL_IER, 0);
+    x86_outb(port + SERIAL_LCR, SERIAL_LCR_DLAB);
+    x86_outb(port + SERIAL_DLL, (uint8_t)(X86_SERIAL_DIVISOR & 0xFF));
+    x86_outb(port + SERIAL_DLM, (uint8_t)(X86_SERIAL_DIVISOR >> 8));
+    x86_outb(port + SERIAL_LCR, SERIAL_LCR_8N1);
+    x86_outb(port + SERIAL_FCR, SERIAL_FCR_ENABLE);
+
+    /* Loop a byte back through the transmitter to be sure it is a UART */
+    x86_outb(port + SERIAL_MCR, SERIAL_MCR_LOOPBACK);
+    x86_outb(port + SERIAL_THR, SERIAL_PROBE_BYTE);
+    uint32_t polls = 0;
+    while (!(x86_inb(port + SERIAL_LSR) & 0x01) && polls < SERIAL_POLLS) {
+        polls++;
+    }
+    if (polls == SERIAL_POLLS || x86_inb(port + SERIAL_THR) != SERIAL_PROBE_BYTE) {
+        x86_outb(port + SERIAL_MCR, 0);
+        return MEOW_ERROR_HARDWARE_FAILURE;
+    }
+
+    x86_outb(port + SERIAL_MCR, SERIAL_MCR_RUN);
+    serial_present = 1;
+    return MEOW_SUCCESS;
+}
+
+uint8_t x86_serial_is_present(void) {
+    return serial_present;
+}
+
+/* The IRQ handler must be registered and the line unmasked first */
+void x86_serial_start_irq(void) {
+    uint32_t flags = meow_spin_lock_irqsave(&serial_lock);
+    serial_irq_driven = serial_present;
+    meow_spin_unlock_irqrestore(&serial_lock, flags);
+}
+
+void x86_serial_write(const char* data, size_t length) {
+    if (!serial_present || !data) {
+        return;
+    }
+
+    uint32_t flags = meow_spin_lock_irqsave(&serial_lock);
+    for (size_t i = 0; i < length; i++) {
+        /* Terminals want CR LF; a capture file doesn't mind */
+        if (data[i] == '\n') {
+            serial_enqueue_internal('\r');
+        }
+        serial_enqueue_internal(data[i]);
+    }
+
+    if (!serial_irq_driven) {
+        while (serial_tail != serial_head) {
+            serial_poll_out_internal();
+        }
+    } else if (!serial_tx_active && serial_tail != serial_head) {
+        /* Prime the FIFO; THRE then fires whenever it runs dry */
+        if (serial_thr_empty_internal()) {
+            serial_fill_fifo_internal();
+        }
+        serial_tx_active = 1;
+        x86_outb(X86_SERIAL_COM1 + SERIAL_IER, SERIAL_IER_THRE);
+    }
+    meow_spin_unlock_irqrestore(&serial_lock, flags);
+}
+
+void x86_serial_irq_handler(uint8_t irq) {
+    (void)irq;
+
+    meow_spin_lock(&serial_lock);
+    uint8_t iir;
+    while (!((iir = x86_inb(X86_SERIAL_COM1 + SERIAL_IIR)) & SERIAL_IIR_NONE)) {
+        if ((iir & SERIAL_IIR_ID_MASK) != SERIAL_IIR_THRE) {
+            /* Only THRE is enabled; anything else is stale */
+            break;
+        }
+        if (serial_tail == serial_head) {
+            x86_outb(X86_SERIAL_COM1 + SERIAL_IER, 0);
+            serial_tx_active = 0;
+            break;
+        }
+        serial_fill_fifo_internal();
+    }
+    meow_spin_unlock(&serial_lock);
+}
+
+/* For panics: empty the ring by polling, even if the lock is held */
+void x86_serial_flush(void) {
+    if (!serial_present) {
+        return;
+    }
+
+    uint32_t flags = meow_irq_save();
+    uint8_t locked = meow_spin_trylock(&serial_lock);
+    x86_outb(X86_SERIAL_COM1 + SERIAL_IER, 0);
+    serial_tx_active = 0;
+    serial_irq_driven = 0;
+    while (serial_tail != serial_head) {
+        serial_poll_out_internal();
+    }
+    if (locked) {
+        meow_spin_unlock(&serial_lock);
+    }
+    meow_irq_restore(flags);
+}
@@ -0,0 +1,180 @@
+/* advanced/hal/x86/x86_smp.c - Application Processor Bring-up
+ *
+ * Starts every enabled CPU the ACPI MADT lists with the INIT-SIPI-SIPI
+ * sequence. Each application processor (AP) enters the real-mode
+ * trampoline in x86_smp_trampoline.S, which brings it to paged protected
+ * mode on a stack of its own; from there it loads its own GDT, the shared
+ * IDT and enables its Local APIC before calling the kernel's entry point.
+ *
+ * APs are started one at a time, so the trampoline and its parameter
+ * block are reused for each.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "x86_meow_hal_interface.h"
+#include "../../mm/meow_physical_memory.h"
+#include "../../kernel/meow_util.h"
+
+#define SMP_INIT_DELAY_US       10000   /* INIT to first STARTUP */
+#define SMP_SIPI_DELAY_US       200     /* Between the two STARTUPs */
+#define SMP_BOOT_TIMEOUT_US     100000  /* For the AP to report in */
+#define SMP_STACK_SIZE          (TERRITORY_SIZE << X86_SMP_STACK_ORDER)
+
+/* Layout of the trampoline's parameter block */
+typedef struct x86_smp_params {
+    uint32_t cr3;
+    uint32_t cr4;
+    uint32_t cr0;
+    uint32_t stack;
+    uint32_t entry;
+} __attribute__((packed)) x86_smp_params_t;
+
+/* Global SMP state */
+static uint8_t cpu_apic_ids[X86_MAX_CPUS];
+static uint8_t apic_id_to_cpu[256];     /* Unknown IDs map to CPU 0 */
+static uint32_t cpu_count = 1;
+static void (*ap_entry)(void) = NULL;
+static volatile uint32_t ap_booting_cpu = 0;
+static volatile uint8_t ap_started = 0;
+static uint8_t smp_started = 0;
+
+/* ============================================================================
+ * INTERNAL HELPERS
+ * ============================================================================ */
+
+/* First C code on an AP, on its own stack with interrupts disabled */
+static void smp_ap_main_internal(void) {
+    uint32_t cpu = ap_booting_cpu;
+
+    x86_gdt_load_cpu(cpu);
+    x86_idt_load();
+    x86_apic_init_ap();
+
+    /* The boot CPU moves on to the next AP once it sees this */
+    ap_started = 1;
+
+    if (ap_entry) {
+        ap_entry();
+    }
+    for (;;) {
+        x86_cli();
+        x86_hlt();
+    }
+}
+
+/* INIT-SIPI-SIPI one AP and wait for it to report in */
+static meow_error_t smp_boot_ap_internal(uint32_t cpu, uint8_t apic_id) {
+    uint32_t stack = purr_alloc_territories(X86_SMP_STACK_ORDER);
+    if (!stack) {
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+
+    volatile x86_smp_params_t* params = (volatile x86_smp_params_t*)
+        (X86_SMP_TRAMPOLINE_ADDR + (x86_smp_trampoline_params - x86_smp_trampoline_start));
+    params->stack = stack + SMP_STACK_SIZE;
+    ap_booting_cpu = cpu;
+    ap_started = 0;
+
+    uint32_t sipi = X86_ICR_STARTUP | (X86_SMP_TRAMPOLINE_ADDR >> 12);
+    MEOW_RETURN_IF_ERROR(x86_apic_send_ipi(apic_id, X86_ICR_INIT | X86_ICR_LEVEL_ASSERT));
+    x86_delay_us(SMP_INIT_DELAY_US);
+    MEOW_RETURN_IF_ERROR(x86_apic_send_ipi(apic_id, sipi));
+    x86_delay_us(SMP_SIPI_DELAY_US);
+    if (!ap_started) {
+        MEOW_RETURN_IF_ERROR(x86_apic_send_ipi(apic_id, sipi));
+    }
+
+    for (uint32_t waited = 0; !ap_started; waited += 100) {
+        if (waited >= SMP_BOOT_TIMEOUT_US) {
+            /* The stack stays allocated: the AP may still wake up on it */
+            return MEOW_ERROR_TIMEOUT;
+        }
+        x86_delay_us(100);
+    }
+    return MEOW_SUCCESS;
+}
+
+/* ============================================================================
+ * SMP INTERFACE
+ * ============================================================================ */
+
+/* Start every other CPU in the MADT; each calls @entry once it is up */
+meow_error_t x86_smp_start_aps(void (*entry)(void)) {
+    if (smp_started) {
+        return MEOW_ERROR_ALREADY_INITIALIZED;
+    }
+    if (!x86_apic_is_enabled()) {
+        return MEOW_ERROR_NOT_SUPPORTED;
+    }
+
+    extern char _kernel_start;
+    uint32_t trampoline_size = x86_smp_trampoline_end - x86_smp_trampoline_start;
+    if (X86_SMP_TRAMPOLINE_ADDR + trampoline_size > (uint32_t)&_kernel_start) {
+        return MEOW_ERROR_INVALID_STATE;
+    }
+
+    /* Low memory below the kernel is reserved from the PMM and identity
+     * mapped, so the copy can be written and executed in place */
+    meow_memcpy((void*)X86_SMP_TRAMPOLINE_ADDR, x86_smp_trampoline_start, trampoline_size);
+    volatile x86_smp_params_t* params = (volatile x86_smp_params_t*)
+        (X86_SMP_TRAMPOLINE_ADDR + (x86_smp_trampoline_params - x86_smp_trampoline_start));
+    params->cr3 = x86_get_cr3();
+    params->cr4 = x86_get_cr4();
+    params->cr0 = x86_get_cr0() & (X86_CR0_PG | X86_CR0_WP);
+    params->entry = (uint32_t)smp_ap_main_internal;
+
+    const x86_madt_info_t* madt = x86_acpi_get_madt();
+    uint8_t bsp_id = x86_apic_get_id();
+    cpu_apic_ids[0] = bsp_id;
+    apic_id_to_cpu[bsp_id] = 0;
+    ap_entry = entry;
+    smp_started = 1;
+
+    for (uint32_t i = 0; i < madt->cpu_count && cpu_count < X86_MAX_CPUS; i++) {
+        uint8_t apic_id = madt->cpu_apic_ids[i];
+        if (apic_id == bsp_id) {
+            continue;
+        }
+
+        uint32_t cpu = cpu_count;
+        cpu_apic_ids[cpu] = apic_id;
+        apic_id_to_cpu[apic_id] = (uint8_t)cpu;
+
+        meow_error_t result = smp_boot_ap_internal(cpu, apic_id);
+        if (result != MEOW_SUCCESS) {
+            /* Don't reuse the trampoline under a CPU that may still run it */
+            apic_id_to_cpu[apic_id] = 0;
+            meow_log(MEOW_LOG_HISS, "x86: CPU with APIC id %u did not start (%d)",
+                     apic_id, result);
+            break;
+        }
+
+        cpu_count++;
+        meow_log(MEOW_LOG_MEOW, "x86: CPU %u (APIC id %u) is up", cpu, apic_id);
+    }
+
+    meow_log(MEOW_LOG_CHIRP, "x86: %u of %u CPUs online", cpu_count, madt->cpu_count);
+    return MEOW_SUCCESS;
+}
+
+/* Index of the calling CPU, from its Local APIC ID */
+uint32_t x86_smp_get_cpu_id(void) {
+    if (!smp_started) {
+        return 0;
+    }
+    return apic_id_to_cpu[x86_apic_get_id()];
+}
+
+uint32_t x86_smp_get_cpu_count(void) {
+    return cpu_count;
+}
+
+/* Interrupt another CPU so it passes through the IRQ exit hook */
+meow_error_t x86_smp_send_reschedule(uint32_t cpu) {
+    if (cpu >= cpu_count) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+    return x86_apic_send_ipi(cpu_apic_ids[cpu], X86_ICR_FIXED | X86_ICR_LEVEL_ASSERT |
+                                                X86_APIC_RESCHEDULE_VECTOR);
+}
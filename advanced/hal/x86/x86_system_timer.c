@@ -5,6 +5,7 @@
 
 #include "x86_meow_hal_interface.h"
 #include "../../kernel/meow_util.h"
+#include "../../kernel/meow_lock.h"
 
 /* PIT I/O Ports */
 #define PIT_CHANNEL0 0x40 /* Channel 0 data port (system timer) */
@@ -53,7 +54,7 @@ meow_error_t x86_pit_init(uint32_t frequency) {
     x86_outb(PIT_CHANNEL0, (divisor >> 8) & 0xFF); /* High byte */
 
     /* Enable timer IRQ (IRQ 0) */
-    x86_pic_enable_irq(0);
+    x86_irq_unmask(0);
 
     meow_log(MEOW_LOG_CHIRP, "x86: PIT configured (divisor: %u, actual frequency: %u Hz)",
              divisor, frequency);
@@ -71,38 +72,287 @@ uint32_t x86_pit_get_divisor(void) {
     return timer_divisor;
 }
 
-/* Sleep for specified milliseconds using timer ticks */
+/* Halt until the PIT clock has advanced by milliseconds. Low level
+ * fallback; kernel code sleeps on the timer wheel with meow_sleep(). */
 meow_error_t x86_pit_sleep(uint32_t milliseconds) {
     if (timer_frequency == 0) {
         meow_log(MEOW_LOG_YOWL, "x86: PIT not initialized, cannot sleep");
         return MEOW_ERROR_NOT_INITIALIZED;
     }
 
-    /* For now, just use a simple busy wait with halt */
-    uint32_t target_loops = milliseconds * 1000; /* Rough approximation */
-    
     meow_log(MEOW_LOG_PURR, "x86: Sleeping for %u ms", milliseconds);
-    
-    for (uint32_t i = 0; i < target_loops; i++) {
+
+    uint64_t deadline = x86_pit_get_ns() + (uint64_t)milliseconds * 1000000;
+    while (x86_pit_get_ns() < deadline) {
         x86_hlt(); /* Halt until next interrupt */
     }
-    
+
     return MEOW_SUCCESS;
 }
 
 /* Enable/disable PIT channel */
 meow_error_t x86_pit_set_enabled(uint8_t enabled) {
     if (enabled) {
-        meow_error_t result = x86_pic_enable_irq(0);
+        meow_error_t result = x86_irq_unmask(0);
         if (result == MEOW_SUCCESS) {
             meow_log(MEOW_LOG_MEOW, "x86: PIT timer enabled");
         }
         return result;
     } else {
-        meow_error_t result = x86_pic_disable_irq(0);
+        meow_error_t result = x86_irq_mask(0);
         if (result == MEOW_SUCCESS) {
             meow_log(MEOW_LOG_MEOW, "x86: PIT timer disabled");
         }
         return result;
     }
-}
\ No newline at end of file
+}
+/* ============================================================================
+ * TSC CLOCKSOURCE
+ * ============================================================================ */
+
+/* PIT channel 2 gate and output live in the speaker control port */
+#define PIT_SPEAKER_PORT      0x61
+#define PIT_SPEAKER_GATE      0x01 /* Channel 2 gate */
+#define PIT_SPEAKER_DATA      0x02 /* Speaker on, kept off while calibrating */
+#define PIT_SPEAKER_OUT       0x20 /* Channel 2 output */
+
+#define TSC_CALIBRATE_MS      10
+#define TSC_CALIBRATE_RUNS    3
+#define TSC_CALIBRATE_LATCH   (PIT_FREQUENCY / (1000 / TSC_CALIBRATE_MS))
+#define TSC_CALIBRATE_POLLS   1000000  /* Give up if channel 2 never fires */
+
+/* ns = (cycles * tsc_mult) >> tsc_shift, with tsc_mult fitting in 32 bits */
+static uint64_t tsc_base = 0;
+static uint32_t tsc_mult = 0;
+static uint32_t tsc_shift = 0;
+static uint32_t tsc_khz = 0;
+static uint8_t tsc_reliable = 0;
+
+/* (a * mul) >> shift for shift <= 32 without a 128-bit product */
+static inline uint64_t mul_u64_u32_shr(uint64_t a, uint32_t mul, uint32_t shift) {
+    uint64_t low = ((uint64_t)(uint32_t)a * mul) >> shift;
+    uint64_t high = ((a >> 32) * mul) << (32 - shift);
+    return low + high;
+}
+
+/* Count TSC cycles over one PIT channel 2 one-shot, 0 on timeout */
+static uint64_t tsc_calibrate_run(void) {
+    uint8_t speaker = x86_inb(PIT_SPEAKER_PORT);
+    uint32_t polls = 0;
+
+    x86_outb(PIT_SPEAKER_PORT, (speaker & ~PIT_SPEAKER_DATA) | PIT_SPEAKER_GATE);
+
+    /* Channel 2, lobyte/hibyte, mode 0: OUT goes high when the count hits 0 */
+    x86_outb(PIT_COMMAND, 0xB0);
+    x86_outb(PIT_CHANNEL2, TSC_CALIBRATE_LATCH & 0xFF);
+    x86_outb(PIT_CHANNEL2, (TSC_CALIBRATE_LATCH >> 8) & 0xFF);
+
+    uint64_t start = x86_rdtsc();
+    while (!(x86_inb(PIT_SPEAKER_PORT) & PIT_SPEAKER_OUT)) {
+        if (++polls > TSC_CALIBRATE_POLLS) {
+            x86_outb(PIT_SPEAKER_PORT, speaker);
+            return 0;
+        }
+    }
+    uint64_t end = x86_rdtsc();
+
+    x86_outb(PIT_SPEAKER_PORT, speaker);
+    return end - start;
+}
+
+/* Calibrate the TSC and decide whether it can be the clocksource */
+meow_error_t x86_tsc_init(void) {
+    if (!x86_cpuid_supported()) {
+        return MEOW_ERROR_NOT_SUPPORTED;
+    }
+
+    uint32_t eax, ebx, ecx, edx;
+    x86_cpuid(1, &eax, &ebx, &ecx, &edx);
+    if (!(edx & X86_FEATURE_TSC)) {
+        meow_log(MEOW_LOG_MEOW, "x86: No TSC, PIT stays the clocksource");
+        return MEOW_ERROR_NOT_SUPPORTED;
+    }
+
+    uint8_t invariant = 0;
+    x86_cpuid(0x80000000, &eax, &ebx, &ecx, &edx);
+    if (eax >= X86_CPUID_EXT_POWER) {
+        x86_cpuid(X86_CPUID_EXT_POWER, &eax, &ebx, &ecx, &edx);
+        invariant = (edx & X86_FEATURE_INVARIANT_TSC) != 0;
+    }
+
+    /* Keep the shortest run: SMIs and emulation only ever add cycles */
+    uint64_t best = 0, worst = 0;
+    for (uint32_t run = 0; run < TSC_CALIBRATE_RUNS; run++) {
+        uint64_t cycles = tsc_calibrate_run();
+        if (cycles == 0) {
+            meow_log(MEOW_LOG_HISS, "x86: PIT channel 2 did not fire, TSC left uncalibrated");
+            return MEOW_ERROR_TIMEOUT;
+        }
+        if (best == 0 || cycles < best) best = cycles;
+        if (cycles > worst) worst = cycles;
+    }
+
+    tsc_khz = (uint32_t)((best * PIT_FREQUENCY) / ((uint64_t)TSC_CALIBRATE_LATCH * 1000));
+    if (tsc_khz == 0) {
+        return MEOW_ERROR_HARDWARE_FAILURE;
+    }
+
+    tsc_shift = 32;
+    while (tsc_shift > 0 && ((1000000ULL << tsc_shift) / tsc_khz) > 0xFFFFFFFFULL) {
+        tsc_shift--;
+    }
+    tsc_mult = (uint32_t)((1000000ULL << tsc_shift) / tsc_khz);
+    tsc_base = x86_rdtsc();
+
+    /* Runs further apart than 1% mean the counter can't be trusted */
+    uint8_t stable = (worst - best) <= best / 100;
+    tsc_reliable = invariant && stable;
+
+    meow_log(MEOW_LOG_CHIRP, "x86: TSC %u.%03u MHz (%s%s), clocksource: %s",
+             tsc_khz / 1000, tsc_khz % 1000, invariant ? "invariant" : "variant",
+             stable ? "" : ", noisy calibration", tsc_reliable ? "TSC" : "PIT");
+    return MEOW_SUCCESS;
+}
+
+uint8_t x86_tsc_is_reliable(void) {
+    return tsc_reliable;
+}
+
+/* Calibrated TSC rate, 0 if calibration never ran or failed */
+uint32_t x86_tsc_get_khz(void) {
+    return tsc_khz;
+}
+
+/* Busy wait on the calibrated TSC; port 0x80 writes take about 1us
+ * each when there is no TSC */
+void x86_delay_us(uint32_t microseconds) {
+    if (tsc_khz == 0) {
+        for (uint32_t i = 0; i < microseconds; i++) {
+            x86_outb(0x80, 0);
+        }
+        return;
+    }
+
+    uint64_t cycles = ((uint64_t)tsc_khz * microseconds) / 1000;
+    uint64_t start = x86_rdtsc();
+    while (x86_rdtsc() - start < cycles) {
+        x86_pause();
+    }
+}
+
+/* Nanoseconds since calibration; only meaningful when the TSC is reliable */
+uint64_t x86_tsc_get_ns(void) {
+    if (tsc_mult == 0) {
+        return 0;
+    }
+    return mul_u64_u32_shr(x86_rdtsc() - tsc_base, tsc_mult, tsc_shift);
+}
+
+/* ============================================================================
+ * PIT CLOCK AND ONE-SHOT MODE
+ * ============================================================================ */
+
+/* ns = (PIT clocks * PIT_NS_MULT) >> PIT_NS_SHIFT, about 838 ns per clock */
+#define PIT_NS_SHIFT          22
+#define PIT_NS_MULT           ((uint32_t)((1000000000ULL << PIT_NS_SHIFT) / PIT_FREQUENCY))
+#define PIT_ONESHOT_MIN       2        /* Shortest count worth programming */
+#define PIT_ONESHOT_MAX       0xFFFF   /* About 54.9 ms */
+
+static uint64_t pit_elapsed = 0;       /* PIT clocks accounted for so far */
+static uint32_t pit_oneshot_count = 0; /* Armed one-shot count, 0 in periodic mode */
+
+/* Covers the two above and the channel 0 read-back sequence. Readers take
+ * it too: a 64-bit read split by IRQ 0 carrying into the high word would
+ * be off by 2^32 clocks, about an hour. */
+MEOW_LOCK_CLASS(pit_lock_class, "pit-clock");
+static meow_spinlock_t pit_lock = MEOW_SPINLOCK_INIT(&pit_lock_class);
+
+/* Latch status and count of channel 0 together and return the PIT clocks
+ * the armed one-shot has consumed. Mode 0 keeps counting down through 0
+ * after it fires, so the time since expiry is recovered from the wrap. */
+static uint32_t pit_oneshot_progress(void) {
+    x86_outb(PIT_COMMAND, 0xC2);       /* Read-back: status and count, channel 0 */
+    uint8_t status = x86_inb(PIT_CHANNEL0);
+    uint32_t current = x86_inb(PIT_CHANNEL0);
+    current |= (uint32_t)x86_inb(PIT_CHANNEL0) << 8;
+
+    if (status & 0x80) {               /* OUT high: the one-shot has fired */
+        return pit_oneshot_count + ((0x10000 - current) & 0xFFFF);
+    }
+    return current <= pit_oneshot_count ? pit_oneshot_count - current : 0;
+}
+
+/* Credit the running one-shot before the counter is reprogrammed */
+static void pit_oneshot_retire(void) {
+    if (pit_oneshot_count) {
+        pit_elapsed += pit_oneshot_progress();
+        pit_oneshot_count = 0;
+    }
+}
+
+/* Account one timer interrupt; called from IRQ 0 */
+void x86_pit_tick(void) {
+    /* One-shot time is read back from the counter when it is retired */
+    meow_spin_lock(&pit_lock);
+    if (!pit_oneshot_count) {
+        pit_elapsed += timer_divisor;
+    }
+    meow_spin_unlock(&pit_lock);
+}
+
+/* Stop the periodic tick and interrupt once, delta_ns from now. Deltas
+ * beyond the 16-bit counter are clamped; the caller just re-arms. */
+meow_error_t x86_pit_set_oneshot(uint64_t delta_ns) {
+    if (timer_divisor == 0) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+
+    uint64_t max_ns = ((uint64_t)PIT_ONESHOT_MAX * PIT_NS_MULT) >> PIT_NS_SHIFT;
+    if (delta_ns > max_ns) {
+        delta_ns = max_ns;
+    }
+    uint32_t count = (uint32_t)((delta_ns << PIT_NS_SHIFT) / PIT_NS_MULT);
+    if (count < PIT_ONESHOT_MIN) {
+        count = PIT_ONESHOT_MIN;
+    }
+
+    uint32_t flags = meow_spin_lock_irqsave(&pit_lock);
+    pit_oneshot_retire();
+
+    /* Channel 0, lobyte/hibyte, mode 0: interrupt on terminal count */
+    x86_outb(PIT_COMMAND, 0x30);
+    x86_outb(PIT_CHANNEL0, count & 0xFF);
+    x86_outb(PIT_CHANNEL0, (count >> 8) & 0xFF);
+    pit_oneshot_count = count;
+    meow_spin_unlock_irqrestore(&pit_lock, flags);
+    return MEOW_SUCCESS;
+}
+
+/* Go back to the periodic square wave at the configured frequency */
+meow_error_t x86_pit_set_periodic(void) {
+    if (timer_divisor == 0) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+    uint32_t flags = meow_spin_lock_irqsave(&pit_lock);
+    if (pit_oneshot_count) {
+        pit_oneshot_retire();
+
+        x86_outb(PIT_COMMAND, 0x36);
+        x86_outb(PIT_CHANNEL0, timer_divisor & 0xFF);
+        x86_outb(PIT_CHANNEL0, (timer_divisor >> 8) & 0xFF);
+    }
+    meow_spin_unlock_irqrestore(&pit_lock, flags);
+    return MEOW_SUCCESS;
+}
+
+/* Nanoseconds counted by the PIT since it was programmed; tick granular
+ * in periodic mode, counter granular while a one-shot is armed */
+uint64_t x86_pit_get_ns(void) {
+    uint32_t flags = meow_spin_lock_irqsave(&pit_lock);
+    uint64_t clocks = pit_elapsed;
+    if (pit_oneshot_count) {
+        clocks += pit_oneshot_progress();
+    }
+    meow_spin_unlock_irqrestore(&pit_lock, flags);
+    return mul_u64_u32_shr(clocks, PIT_NS_MULT, PIT_NS_SHIFT);
+}
@@ -5,7 +5,10 @@
 
 #include "meow_heap_allocator.h"
 #include "meow_memory_manager.h"
+#include "meow_physical_memory.h"
 #include "../../kernel/meow_util.h"
+#include "../../kernel/meow_lock.h"
+#include "../../kernel/meow_trace.h"
 
 /* ============================================================================
  * CAT HEAP GLOBAL STATE
@@ -21,13 +24,79 @@ static uint8_t heap_initialized = 0;
 /* Cat-themed statistics */
 static cat_heap_stats_t heap_stats = {0};
 
+/* Guards the free lists, the regions and the statistics */
+MEOW_LOCK_CLASS(heap_lock_class, "cat-heap");
+static meow_spinlock_t heap_lock = MEOW_SPINLOCK_INIT(&heap_lock_class);
+
+/**
+ * cat_heap_region - One contiguous piece of the heap
+ *
+ * The initial window and every territory run pulled from the PMM start
+ * with this descriptor, followed by a prologue tag, the blocks and an
+ * epilogue header. Regions are kept in the order they were added so the
+ * newest one can be handed back first.
+ */
+typedef struct cat_heap_region {
+    struct cat_heap_region* next;       /* Next (newer) region */
+    struct cat_heap_region* prev;       /* Previous (older) region */
+    uint32_t size;                      /* Bytes including this descriptor */
+    uint32_t territories;               /* PMM territories, 0 for the initial window */
+} cat_heap_region_t;
+
+static cat_heap_region_t* heap_first_region = NULL;
+static cat_heap_region_t* heap_last_region = NULL;
+
+/* Overhead of an empty region around its single free block */
+#define HEAP_REGION_OVERHEAD \
+    (sizeof(cat_heap_region_t) + sizeof(cat_memory_footer_t) + \
+     sizeof(cat_memory_block_t) + MEOW_HEAP_BLOCK_OVERHEAD)
+
+/* Segregated free lists, one per size class, plus a bitmap of non-empty classes */
+static cat_memory_block_t* heap_free_lists[MEOW_HEAP_SIZE_CLASSES];
+static uint32_t heap_class_bitmap = 0;
+
+/**
+ * cat_free_links - Free list links kept in the user area of a free block
+ *
+ * Free blocks have no user data, so the first two words of their payload
+ * hold the doubly-linked class list pointers. MEOW_HEAP_MIN_BLOCK_SIZE
+ * guarantees there is always room for them.
+ */
+typedef struct cat_free_links {
+    cat_memory_block_t* next_free;
+    cat_memory_block_t* prev_free;
+} cat_free_links_t;
+
+#define HEAP_FREE_LINKS(block) \
+    ((cat_free_links_t*)((uint8_t*)(block) + sizeof(cat_memory_block_t)))
+
+/* Boundary tag navigation between physically adjacent blocks */
+#define HEAP_BLOCK_FOOTER(block) \
+    ((cat_memory_footer_t*)((uint8_t*)(block) + sizeof(cat_memory_block_t) + (block)->size))
+#define HEAP_NEXT_PHYSICAL(block) \
+    ((cat_memory_block_t*)((uint8_t*)(block) + MEOW_HEAP_BLOCK_OVERHEAD + (block)->size))
+#define HEAP_PREV_FOOTER(block) \
+    ((cat_memory_footer_t*)((uint8_t*)(block) - sizeof(cat_memory_footer_t)))
+#define HEAP_BLOCK_FROM_FOOTER(footer) \
+    ((cat_memory_block_t*)((uint8_t*)(footer) - (footer)->size - sizeof(cat_memory_block_t)))
+
 /* ============================================================================
  * FORWARD DECLARATIONS (Functions used before defined)
  * ============================================================================ */
 
-static void merge_free_blocks_internal(void);
+static cat_memory_block_t* coalesce_block_internal(cat_memory_block_t* block);
+static void write_footer_internal(cat_memory_block_t* block);
+static cat_memory_block_t* region_setup_internal(uintptr_t base, uint32_t size,
+                                                 uint32_t territories);
+static cat_memory_block_t* heap_grow_internal(size_t size);
+static uint32_t region_release_internal(cat_heap_region_t* region);
+static uint32_t heap_trim_internal(void);
 static cat_memory_block_t* find_free_block_internal(size_t size);
 static meow_error_t validate_pointer_internal(const void* ptr);
+static uint32_t size_to_class_internal(uint32_t size);
+static uint32_t class_min_size_internal(uint32_t class_index);
+static void free_list_insert_internal(cat_memory_block_t* block);
+static void free_list_remove_internal(cat_memory_block_t* block);
 
 /* ============================================================================
  * MAIN HEAP INTERFACE FUNCTIONS (ONLY THESE - NO REDEFINITIONS)
@@ -44,33 +113,30 @@ meow_error_t meow_heap_init(void) {
 
     meow_log(MEOW_LOG_CHIRP, "Initializing cat heap allocator...");
 
-    /* Initialize the first cat bed (memory block) */
-    first_cat_bed = (cat_memory_block_t*)MEOW_HEAP_START;
-    first_cat_bed->size = MEOW_HEAP_SIZE_BYTES - sizeof(cat_memory_block_t);
-    first_cat_bed->occupied = 0; /* No cat sleeping yet */
-    first_cat_bed->flags = MEOW_HEAP_BLOCK_FREE;
-    first_cat_bed->magic = MEOW_HEAP_MAGIC_VALUE;
-    first_cat_bed->next_bed = NULL;
-    first_cat_bed->guard_front = MEOW_HEAP_GUARD_PATTERN;
+    /* Initialize comprehensive statistics */
+    meow_memset(&heap_stats, 0, sizeof(heap_stats));
+    for (uint32_t i = 0; i < MEOW_HEAP_SIZE_CLASSES; i++) {
+        heap_free_lists[i] = NULL;
+        heap_stats.classes[i].min_size = class_min_size_internal(i);
+    }
+    heap_class_bitmap = 0;
 
     /* Initialize heap statistics */
-    heap_total_size = MEOW_HEAP_SIZE_BYTES;
-    heap_used_size = sizeof(cat_memory_block_t); /* Header block */
-    heap_free_size = first_cat_bed->size;
-    heap_block_count = 1;
+    heap_first_region = NULL;
+    heap_last_region = NULL;
+    heap_total_size = 0;
+    heap_free_size = 0;
+    heap_block_count = 0;
     heap_initialized = 1;
 
-    /* Initialize comprehensive statistics */
+    /* The initial window starts out as one free cat bed */
+    first_cat_bed = region_setup_internal(MEOW_HEAP_START, MEOW_HEAP_SIZE_BYTES, 0);
+    heap_used_size = heap_total_size - heap_free_size; /* Fences and tags */
+
     heap_stats.total_size = heap_total_size;
     heap_stats.used_size = heap_used_size;
     heap_stats.free_size = heap_free_size;
     heap_stats.block_count = heap_block_count;
-    heap_stats.free_blocks = 1;
-    heap_stats.occupied_blocks = 0;
-    heap_stats.allocations = 0;
-    heap_stats.deallocations = 0;
-    heap_stats.failures = 0;
-    heap_stats.corruptions = 0;
 
     meow_log(MEOW_LOG_CHIRP, "Cat heap initialized: %d KB at 0x%08x",
              heap_total_size / 1024, MEOW_HEAP_START);
@@ -95,7 +161,16 @@ meow_error_t meow_heap_shutdown(void) {
     }
 
     /* Reset all state */
+    while (heap_last_region && heap_last_region->territories > 0) {
+        region_release_internal(heap_last_region);
+    }
     first_cat_bed = NULL;
+    heap_first_region = NULL;
+    heap_last_region = NULL;
+    for (uint32_t i = 0; i < MEOW_HEAP_SIZE_CLASSES; i++) {
+        heap_free_lists[i] = NULL;
+    }
+    heap_class_bitmap = 0;
     heap_total_size = 0;
     heap_used_size = 0;
     heap_free_size = 0;
@@ -135,28 +210,36 @@ void* meow_heap_alloc(size_t size) {
         size = MEOW_HEAP_MIN_BLOCK_SIZE;
     }
 
-    /* Find a suitable free block */
+    /* Find a suitable free block and take it off its class list */
+    uint32_t flags = meow_spin_lock_irqsave(&heap_lock);
     cat_memory_block_t* block = find_free_block_internal(size);
     if (!block) {
-        meow_log(MEOW_LOG_YOWL, "No suitable free block found for size %zu", size);
+        block = heap_grow_internal(size);
+    }
+    if (!block) {
         heap_stats.failures++;
+        meow_spin_unlock_irqrestore(&heap_lock, flags);
+        meow_log(MEOW_LOG_YOWL, "No suitable free block found for size %zu", size);
         return NULL;
     }
+    free_list_remove_internal(block);
 
-    /* Split block if it's too big */
-    if (block->size > size + sizeof(cat_memory_block_t) + MEOW_HEAP_MIN_BLOCK_SIZE) {
-        uintptr_t new_block_addr = (uintptr_t)block + sizeof(cat_memory_block_t) + size;
+    /* Split block if it's too big and hand the tail back to its class */
+    if (block->size >= size + MEOW_HEAP_BLOCK_OVERHEAD + MEOW_HEAP_MIN_BLOCK_SIZE) {
+        uintptr_t new_block_addr = (uintptr_t)block + MEOW_HEAP_BLOCK_OVERHEAD + size;
         
         /* Validate the new block address */
-        if (new_block_addr >= MEOW_HEAP_END || new_block_addr < (uintptr_t)block) {
-            meow_log(MEOW_LOG_YOWL, "Block split would cause overflow!");
+        if (new_block_addr < (uintptr_t)block) {
+            free_list_insert_internal(block);
             heap_stats.failures++;
+            meow_spin_unlock_irqrestore(&heap_lock, flags);
+            meow_log(MEOW_LOG_YOWL, "Block split would cause overflow!");
             return NULL;
         }
 
         /* Create new free block */
         cat_memory_block_t* new_block = (cat_memory_block_t*)new_block_addr;
-        new_block->size = block->size - size - sizeof(cat_memory_block_t);
+        new_block->size = block->size - size - MEOW_HEAP_BLOCK_OVERHEAD;
         new_block->occupied = 0;
         new_block->flags = MEOW_HEAP_BLOCK_FREE;
         new_block->magic = MEOW_HEAP_MAGIC_VALUE;
@@ -167,29 +250,28 @@ void* meow_heap_alloc(size_t size) {
         block->next_bed = new_block;
         block->size = size;
         heap_block_count++;
-        heap_stats.free_blocks++;
+        write_footer_internal(new_block);
+        free_list_insert_internal(new_block);
     }
 
     /* Mark block as occupied */
     block->occupied = 1;
     block->flags = MEOW_HEAP_BLOCK_OCCUPIED;
+    write_footer_internal(block);
 
     /* Update statistics */
-    heap_used_size += size + sizeof(cat_memory_block_t);
-    heap_free_size -= size + sizeof(cat_memory_block_t);
+    heap_used_size = heap_total_size - heap_free_size;
     heap_stats.allocations++;
     heap_stats.used_size = heap_used_size;
     heap_stats.free_size = heap_free_size;
     heap_stats.occupied_blocks++;
-    if (heap_stats.free_blocks > 0) {
-        heap_stats.free_blocks--;
-    }
+    meow_spin_unlock_irqrestore(&heap_lock, flags);
 
     /* Return pointer to user data area */
     void* user_ptr = (void*)((uint8_t*)block + sizeof(cat_memory_block_t));
     
-    meow_log(MEOW_LOG_PURR, "Cat found cozy space at 0x%08x (%zu bytes)",
-             (uint32_t)user_ptr, size);
+    MEOW_TRACE("heap: cat found cozy space at 0x%08x (%u bytes)",
+               (uint32_t)user_ptr, (uint32_t)size);
     
     return user_ptr;
 }
@@ -208,10 +290,12 @@ meow_error_t meow_heap_free(void* ptr) {
     }
 
     /* Validate the pointer */
+    uint32_t flags = meow_spin_lock_irqsave(&heap_lock);
     meow_error_t validation = validate_pointer_internal(ptr);
     if (validation != MEOW_SUCCESS) {
-        meow_log(MEOW_LOG_YOWL, "Invalid pointer passed to meow_heap_free: 0x%08x", (uint32_t)ptr);
         heap_stats.corruptions++;
+        meow_spin_unlock_irqrestore(&heap_lock, flags);
+        meow_log(MEOW_LOG_YOWL, "Invalid pointer passed to meow_heap_free: 0x%08x", (uint32_t)ptr);
         return validation;
     }
 
@@ -220,29 +304,40 @@ meow_error_t meow_heap_free(void* ptr) {
     
     /* Validate block */
     if (!block->occupied || block->magic != MEOW_HEAP_MAGIC_VALUE) {
+        heap_stats.corruptions++;
+        meow_spin_unlock_irqrestore(&heap_lock, flags);
         meow_log(MEOW_LOG_YOWL, "Attempting to free already free or corrupted block!");
+        return MM_ERROR_HEAP_CORRUPTION;
+    }
+
+    if (HEAP_BLOCK_FOOTER(block)->guard_back != MEOW_HEAP_GUARD_PATTERN) {
         heap_stats.corruptions++;
+        meow_spin_unlock_irqrestore(&heap_lock, flags);
+        meow_log(MEOW_LOG_YOWL, "Back guard of block 0x%08x trampled!", (uint32_t)block);
         return MM_ERROR_HEAP_CORRUPTION;
     }
 
-    /* Mark block as free */
+    /* Mark block as free, merge with free neighbours, then file it */
     block->occupied = 0;
     block->flags = MEOW_HEAP_BLOCK_FREE;
+    block = coalesce_block_internal(block);
+    free_list_insert_internal(block);
+
+    /* An emptied newest region goes back when the PMM is running low */
+    if (heap_last_region && heap_last_region->territories > 0 &&
+        get_free_territories() < MEOW_HEAP_PRESSURE_TERRITORIES) {
+        heap_trim_internal();
+    }
 
     /* Update statistics */
-    heap_used_size -= block->size + sizeof(cat_memory_block_t);
-    heap_free_size += block->size + sizeof(cat_memory_block_t);
+    heap_used_size = heap_total_size - heap_free_size;
     heap_stats.deallocations++;
     heap_stats.used_size = heap_used_size;
     heap_stats.free_size = heap_free_size;
     heap_stats.occupied_blocks--;
-    heap_stats.free_blocks++;
-
-    meow_log(MEOW_LOG_PURR, "Cat left their space at 0x%08x", (uint32_t)ptr);
-
-    /* Merge adjacent free blocks */
-    merge_free_blocks_internal();
+    meow_spin_unlock_irqrestore(&heap_lock, flags);
 
+    MEOW_TRACE("heap: cat left their space at 0x%08x", (uint32_t)ptr);
     return MEOW_SUCCESS;
 }
 
@@ -265,15 +360,26 @@ void* meow_heap_realloc(void* ptr, size_t new_size) {
         return NULL;
     }
 
-    /* Validate the existing pointer */
+    /* Validate the existing pointer under the lock, as a trim can hand
+     * its region back meanwhile */
+    uint32_t flags = meow_spin_lock_irqsave(&heap_lock);
     if (validate_pointer_internal(ptr) != MEOW_SUCCESS) {
+        heap_stats.corruptions++;
+        meow_spin_unlock_irqrestore(&heap_lock, flags);
         meow_log(MEOW_LOG_YOWL, "Invalid pointer in realloc: 0x%08x", (uint32_t)ptr);
         return NULL;
     }
 
     /* Get current block */
     cat_memory_block_t* block = (cat_memory_block_t*)((uint8_t*)ptr - sizeof(cat_memory_block_t));
+    if (!block->occupied || block->magic != MEOW_HEAP_MAGIC_VALUE) {
+        heap_stats.corruptions++;
+        meow_spin_unlock_irqrestore(&heap_lock, flags);
+        meow_log(MEOW_LOG_YOWL, "Attempting to realloc free or corrupted block!");
+        return NULL;
+    }
     size_t old_size = block->size;
+    meow_spin_unlock_irqrestore(&heap_lock, flags);
 
     /* Align new size */
     new_size = MEOW_HEAP_ALIGN(new_size);
@@ -334,10 +440,12 @@ meow_error_t meow_heap_get_stats(cat_heap_stats_t* stats) {
     }
 
     /* Update dynamic statistics */
+    uint32_t flags = meow_spin_lock_irqsave(&heap_lock);
     heap_stats.total_size = heap_total_size;
     heap_stats.used_size = heap_used_size;
     heap_stats.free_size = heap_free_size;
     heap_stats.block_count = heap_block_count;
+    heap_stats.class_bitmap = heap_class_bitmap;
 
     /* Calculate fragmentation */
     if (heap_stats.free_blocks > 0 && heap_stats.free_size > 0) {
@@ -348,7 +456,8 @@ meow_error_t meow_heap_get_stats(cat_heap_stats_t* stats) {
     }
 
     /* Copy statistics */
-    *stats = heap_stats;
+    meow_memcpy(stats, &heap_stats, sizeof(heap_stats));
+    meow_spin_unlock_irqrestore(&heap_lock, flags);
     return MEOW_SUCCESS;
 }
 
@@ -379,6 +488,17 @@ void meow_heap_print_stats(void) {
     meow_printf("Utilization:     %u%%\n",
         heap_total_size > 0 ? (heap_used_size * 100) / heap_total_size : 0);
     meow_printf("Fragmentation:   %.2f%%\n", heap_stats.fragmentation);
+    meow_printf("Regions:         %u (%u grown, %u shrunk)\n", heap_stats.region_count,
+        heap_stats.grow_events, heap_stats.shrink_events);
+    meow_printf("---- size classes (min size: free / requests / hit%%) ----\n");
+    for (uint32_t i = 0; i < MEOW_HEAP_SIZE_CLASSES; i++) {
+        const cat_heap_class_stats_t* cls = &heap_stats.classes[i];
+        if (cls->requests == 0 && cls->free_blocks == 0) {
+            continue;
+        }
+        meow_printf("  %8u: %u / %u / %u%%\n", cls->min_size, cls->free_blocks,
+            cls->requests, cls->requests > 0 ? (cls->hits * 100) / cls->requests : 0);
+    }
     meow_printf("================================\n\n");
 }
 
@@ -411,7 +531,7 @@ meow_error_t meow_heap_validate(void) {
         }
 
         /* Validate block size */
-        if (current->size == 0 || current->size > MEOW_HEAP_SIZE_BYTES) {
+        if (current->size == 0 || current->size > heap_total_size) {
             meow_log(MEOW_LOG_YOWL, "Invalid block size %u at 0x%08x",
                 current->size, (uint32_t)current);
             corruptions++;
@@ -424,6 +544,27 @@ meow_error_t meow_heap_validate(void) {
             corruptions++;
         }
 
+        /* Validate boundary tag against the header */
+        cat_memory_footer_t* footer = HEAP_BLOCK_FOOTER(current);
+        if (current->size <= heap_total_size &&
+            (footer->guard_back != MEOW_HEAP_GUARD_PATTERN ||
+             footer->magic != MEOW_HEAP_MAGIC_VALUE ||
+             footer->size != current->size ||
+             footer->occupied != current->occupied)) {
+            meow_log(MEOW_LOG_YOWL, "Boundary tag mismatch at block 0x%08x",
+                (uint32_t)current);
+            corruptions++;
+        }
+
+        /* The chain must follow physical order inside a region */
+        if (current->next_bed && current->size <= heap_total_size &&
+            current->next_bed != HEAP_NEXT_PHYSICAL(current) &&
+            HEAP_NEXT_PHYSICAL(current)->flags != MEOW_HEAP_BLOCK_GUARD) {
+            meow_log(MEOW_LOG_YOWL, "Chain out of order after block 0x%08x",
+                (uint32_t)current);
+            corruptions++;
+        }
+
         current = current->next_bed;
 
         /* Prevent infinite loops */
@@ -457,17 +598,105 @@ meow_error_t meow_heap_validate(void) {
  * INTERNAL HELPER FUNCTIONS
  * ============================================================================ */
 
+/**
+ * size_to_class_internal - Map a block size to its segregated size class
+ */
+static uint32_t size_to_class_internal(uint32_t size) {
+    if (size < MEOW_HEAP_SMALL_CLASS_LIMIT) {
+        return (size / MEOW_HEAP_SMALL_CLASS_STEP) - 1;
+    }
+
+    /* Power-of-two classes start right after the small ones at 2^8 */
+    uint32_t class_index = MEOW_HEAP_SMALL_CLASSES + (31 - __builtin_clz(size)) - 8;
+    return class_index < MEOW_HEAP_SIZE_CLASSES ? class_index : MEOW_HEAP_SIZE_CLASSES - 1;
+}
+
+/**
+ * class_min_size_internal - Smallest block size stored in a size class
+ */
+static uint32_t class_min_size_internal(uint32_t class_index) {
+    if (class_index < MEOW_HEAP_SMALL_CLASSES) {
+        return (class_index + 1) * MEOW_HEAP_SMALL_CLASS_STEP;
+    }
+    return 1u << (class_index - MEOW_HEAP_SMALL_CLASSES + 8);
+}
+
+/**
+ * free_list_insert_internal - Push a free block onto its class list
+ */
+static void free_list_insert_internal(cat_memory_block_t* block) {
+    uint32_t class_index = size_to_class_internal(block->size);
+    cat_free_links_t* links = HEAP_FREE_LINKS(block);
+
+    links->prev_free = NULL;
+    links->next_free = heap_free_lists[class_index];
+    if (links->next_free) {
+        HEAP_FREE_LINKS(links->next_free)->prev_free = block;
+    }
+    heap_free_lists[class_index] = block;
+    heap_class_bitmap |= (1u << class_index);
+
+    heap_free_size += block->size;
+    heap_stats.free_blocks++;
+    heap_stats.classes[class_index].free_blocks++;
+}
+
+/**
+ * free_list_remove_internal - Unlink a free block from its class list
+ */
+static void free_list_remove_internal(cat_memory_block_t* block) {
+    uint32_t class_index = size_to_class_internal(block->size);
+    cat_free_links_t* links = HEAP_FREE_LINKS(block);
+
+    if (links->prev_free) {
+        HEAP_FREE_LINKS(links->prev_free)->next_free = links->next_free;
+    } else {
+        heap_free_lists[class_index] = links->next_free;
+    }
+    if (links->next_free) {
+        HEAP_FREE_LINKS(links->next_free)->prev_free = links->prev_free;
+    }
+    if (!heap_free_lists[class_index]) {
+        heap_class_bitmap &= ~(1u << class_index);
+    }
+
+    heap_free_size -= block->size;
+    heap_stats.free_blocks--;
+    heap_stats.classes[class_index].free_blocks--;
+}
+
 /**
  * find_free_block_internal - Find a free block of suitable size
+ *
+ * Checks the head of the request's own class first. Failing that, any
+ * block from the next non-empty larger class is guaranteed to fit, and
+ * the bitmap finds that class with a single bit scan. Only when no larger
+ * class has blocks is the request's own class walked.
  */
 static cat_memory_block_t* find_free_block_internal(size_t size) {
-    cat_memory_block_t* current = first_cat_bed;
-    
-    while (current) {
-        if (!current->occupied && current->size >= size) {
-            return current;
+    uint32_t class_index = size_to_class_internal(size);
+    cat_heap_class_stats_t* cls = &heap_stats.classes[class_index];
+    cat_memory_block_t* block = heap_free_lists[class_index];
+
+    cls->requests++;
+
+    if (block && block->size >= size) {
+        cls->hits++;
+        return block;
+    }
+
+    uint32_t larger = (class_index + 1 < MEOW_HEAP_SIZE_CLASSES) ?
+        heap_class_bitmap & ~((2u << class_index) - 1) : 0;
+    if (larger) {
+        return heap_free_lists[__builtin_ctz(larger)];
+    }
+
+    /* Last resort: the rest of our own class may still hold a fit */
+    for (; block; block = HEAP_FREE_LINKS(block)->next_free) {
+        if (block->size >= size) {
+            cls->hits++;
+            return block;
         }
-        current = current->next_bed;
     }
     
     return NULL;
@@ -483,45 +712,231 @@ static meow_error_t validate_pointer_internal(const void* ptr) {
 
     uintptr_t addr = (uintptr_t)ptr;
     
-    /* Check if pointer is within heap bounds */
-    if (addr < MEOW_HEAP_START + sizeof(cat_memory_block_t) || addr >= MEOW_HEAP_END) {
-        return MM_ERROR_INVALID_ADDRESS;
+    /* Check if pointer is within the bounds of one of the heap regions */
+    for (cat_heap_region_t* region = heap_first_region; region; region = region->next) {
+        uintptr_t start = (uintptr_t)region + sizeof(cat_heap_region_t) +
+                          sizeof(cat_memory_footer_t) + sizeof(cat_memory_block_t);
+        uintptr_t end = (uintptr_t)region + region->size;
+        if (addr >= start && addr < end) {
+            return MEOW_SUCCESS;
+        }
     }
 
-    return MEOW_SUCCESS;
+    return MM_ERROR_INVALID_ADDRESS;
 }
 
 /**
- * merge_free_blocks_internal - Merge adjacent free blocks
+ * write_footer_internal - Mirror a block header into its boundary tag
  */
-static void merge_free_blocks_internal(void) {
-    if (!heap_initialized) {
-        return;
+static void write_footer_internal(cat_memory_block_t* block) {
+    cat_memory_footer_t* footer = HEAP_BLOCK_FOOTER(block);
+    footer->guard_back = MEOW_HEAP_GUARD_PATTERN;
+    footer->size = block->size;
+    footer->occupied = block->occupied;
+    footer->flags = block->flags;
+    footer->magic = MEOW_HEAP_MAGIC_VALUE;
+}
+
+/**
+ * coalesce_block_internal - Merge a newly freed block with free neighbours
+ *
+ * Looks only at the header right after the block and the footer right
+ * before it, so the cost does not depend on heap size. Neighbours that
+ * are merged in are taken off their class lists; the caller files the
+ * returned block.
+ */
+static cat_memory_block_t* coalesce_block_internal(cat_memory_block_t* block) {
+    cat_memory_block_t* next = HEAP_NEXT_PHYSICAL(block);
+    if (!next->occupied && next->magic == MEOW_HEAP_MAGIC_VALUE) {
+        free_list_remove_internal(next);
+        block->size += next->size + MEOW_HEAP_BLOCK_OVERHEAD;
+        block->next_bed = next->next_bed;
+        next->magic = 0;
+        heap_block_count--;
+    }
+
+    cat_memory_footer_t* prev_footer = HEAP_PREV_FOOTER(block);
+    if (!prev_footer->occupied && prev_footer->magic == MEOW_HEAP_MAGIC_VALUE) {
+        cat_memory_block_t* prev = HEAP_BLOCK_FROM_FOOTER(prev_footer);
+        free_list_remove_internal(prev);
+        prev->size += block->size + MEOW_HEAP_BLOCK_OVERHEAD;
+        prev->next_bed = block->next_bed;
+        block->magic = 0;
+        heap_block_count--;
+        block = prev;
+    }
+
+    write_footer_internal(block);
+    return block;
+}
+
+/* ============================================================================
+ * HEAP REGION MANAGEMENT
+ * ============================================================================ */
+
+/**
+ * region_setup_internal - Fence a raw memory range and add it to the heap
+ *
+ * Returns the region's single free block, already on its class list and
+ * appended to the next_bed chain.
+ */
+static cat_memory_block_t* region_setup_internal(uintptr_t base, uint32_t size,
+                                                 uint32_t territories) {
+    cat_heap_region_t* region = (cat_heap_region_t*)base;
+    region->size = size;
+    region->territories = territories;
+
+    /* Fence the region: an occupied prologue tag and a zero-sized epilogue */
+    cat_memory_footer_t* prologue =
+        (cat_memory_footer_t*)(base + sizeof(cat_heap_region_t));
+    prologue->guard_back = MEOW_HEAP_GUARD_PATTERN;
+    prologue->size = 0;
+    prologue->occupied = 1;
+    prologue->flags = MEOW_HEAP_BLOCK_GUARD;
+    prologue->magic = MEOW_HEAP_MAGIC_VALUE;
+
+    cat_memory_block_t* epilogue =
+        (cat_memory_block_t*)(base + size - sizeof(cat_memory_block_t));
+    epilogue->size = 0;
+    epilogue->occupied = 1;
+    epilogue->flags = MEOW_HEAP_BLOCK_GUARD;
+    epilogue->magic = MEOW_HEAP_MAGIC_VALUE;
+    epilogue->next_bed = NULL;
+    epilogue->guard_front = MEOW_HEAP_GUARD_PATTERN;
+
+    /* One free cat bed spans everything between the fences */
+    cat_memory_block_t* block =
+        (cat_memory_block_t*)((uint8_t*)prologue + sizeof(cat_memory_footer_t));
+    block->size = size - HEAP_REGION_OVERHEAD;
+    block->occupied = 0;
+    block->flags = MEOW_HEAP_BLOCK_FREE;
+    block->magic = MEOW_HEAP_MAGIC_VALUE;
+    block->next_bed = NULL;
+    block->guard_front = MEOW_HEAP_GUARD_PATTERN;
+    write_footer_internal(block);
+
+    /* Chain the new region behind the last block of the newest region */
+    region->next = NULL;
+    region->prev = heap_last_region;
+    if (heap_last_region) {
+        cat_memory_block_t* last_epilogue = (cat_memory_block_t*)
+            ((uint8_t*)heap_last_region + heap_last_region->size - sizeof(cat_memory_block_t));
+        HEAP_BLOCK_FROM_FOOTER(HEAP_PREV_FOOTER(last_epilogue))->next_bed = block;
+        heap_last_region->next = region;
+    } else {
+        heap_first_region = region;
     }
+    heap_last_region = region;
 
-    cat_memory_block_t* current = first_cat_bed;
-    uint32_t merges = 0;
-
-    while (current && current->next_bed) {
-        if (!current->occupied && !current->next_bed->occupied) {
-            /* Check if blocks are adjacent */
-            uint8_t* current_end = (uint8_t*)current + sizeof(cat_memory_block_t) + current->size;
-            uint8_t* next_start = (uint8_t*)current->next_bed;
-
-            if (current_end == next_start) {
-                /* Blocks are adjacent, merge them */
-                current->size += current->next_bed->size + sizeof(cat_memory_block_t);
-                current->next_bed = current->next_bed->next_bed;
-                heap_block_count--;
-                heap_stats.free_blocks--;
-                merges++;
-                continue; /* Check again with same current block */
-            }
+    heap_total_size += size;
+    heap_block_count++;
+    heap_stats.region_count++;
+    free_list_insert_internal(block);
+    return block;
+}
+
+/**
+ * heap_grow_internal - Add a region from the PMM large enough for @size
+ */
+static cat_memory_block_t* heap_grow_internal(size_t size) {
+    if (!is_purr_memory_initialized()) {
+        return NULL;
+    }
+
+    uint32_t territories = (uint32_t)(size + HEAP_REGION_OVERHEAD + TERRITORY_SIZE - 1) /
+                           TERRITORY_SIZE;
+    if (territories < MEOW_HEAP_GROW_MIN_TERRITORIES) {
+        territories = MEOW_HEAP_GROW_MIN_TERRITORIES;
+    }
+
+    uint32_t bytes = territories * TERRITORY_SIZE;
+    if (heap_total_size + bytes > MEOW_HEAP_MAX_SIZE_BYTES) {
+        meow_log(MEOW_LOG_HISS, "Cat heap at its %u MB ceiling", MEOW_HEAP_MAX_SIZE_MB);
+        return NULL;
+    }
+
+    uint32_t base = purr_alloc_territory_run(territories);
+    if (!base) {
+        return NULL;
+    }
+
+    cat_memory_block_t* block = region_setup_internal(base, bytes, territories);
+    heap_stats.grow_events++;
+    meow_log(MEOW_LOG_MEOW, "Cat heap grew by %u KB at 0x%08x", bytes / 1024, base);
+
+    return block;
+}
+
+/**
+ * region_release_internal - Hand an empty newest region back to the PMM
+ */
+static uint32_t region_release_internal(cat_heap_region_t* region) {
+    cat_memory_block_t* block = (cat_memory_block_t*)((uint8_t*)region +
+        sizeof(cat_heap_region_t) + sizeof(cat_memory_footer_t));
+    uint32_t territories = region->territories;
+
+    free_list_remove_internal(block);
+    heap_total_size -= region->size;
+    heap_block_count--;
+    heap_stats.region_count--;
+
+    heap_last_region = region->prev;
+    if (heap_last_region) {
+        cat_memory_block_t* last_epilogue = (cat_memory_block_t*)
+            ((uint8_t*)heap_last_region + heap_last_region->size - sizeof(cat_memory_block_t));
+        HEAP_BLOCK_FROM_FOOTER(HEAP_PREV_FOOTER(last_epilogue))->next_bed = NULL;
+        heap_last_region->next = NULL;
+    } else {
+        heap_first_region = NULL;
+    }
+
+    purr_free_territory_run((uint32_t)(uintptr_t)region, territories);
+    return territories;
+}
+
+/**
+ * heap_trim_internal - Release empty trailing regions, heap lock held
+ */
+static uint32_t heap_trim_internal(void) {
+    uint32_t released = 0;
+
+    while (heap_last_region && heap_last_region->territories > 0) {
+        cat_memory_block_t* block = (cat_memory_block_t*)((uint8_t*)heap_last_region +
+            sizeof(cat_heap_region_t) + sizeof(cat_memory_footer_t));
+        if (block->occupied ||
+            block->size != heap_last_region->size - HEAP_REGION_OVERHEAD) {
+            break;
         }
-        current = current->next_bed;
+        released += region_release_internal(heap_last_region);
+        heap_stats.shrink_events++;
     }
 
-    if (merges > 0) {
-        meow_log(MEOW_LOG_PURR, "Merged %u adjacent free blocks", merges);
+    if (released > 0) {
+        heap_used_size = heap_total_size - heap_free_size;
+        heap_stats.used_size = heap_used_size;
+        heap_stats.free_size = heap_free_size;
+        meow_log(MEOW_LOG_MEOW, "Cat heap shrank by %u territories", released);
     }
-}
\ No newline at end of file
+    return released;
+}
+
+/**
+ * meow_heap_trim - Give fully empty trailing regions back to the PMM
+ *
+ * Best effort: the PMM calls this when it runs low, possibly while this
+ * CPU is inside the heap itself, so a busy heap is simply skipped.
+ */
+uint32_t meow_heap_trim(void) {
+    if (!heap_initialized) {
+        return 0;
+    }
+
+    uint32_t flags = meow_irq_save();
+    if (!meow_spin_trylock(&heap_lock)) {
+        meow_irq_restore(flags);
+        return 0;
+    }
+    uint32_t released = heap_trim_internal();
+    meow_spin_unlock_irqrestore(&heap_lock, flags);
+    return released;
+}
@@ -17,17 +17,29 @@
  * ============================================================================ */
 
 /* Memory layout constants - eliminated magic numbers */
-#define MEOW_HEAP_SIZE_MB           1
+#define MEOW_HEAP_SIZE_MB           1         /* Initial window, reserved in the PMM */
 #define MEOW_HEAP_SIZE_BYTES        (MEOW_HEAP_SIZE_MB * 1024 * 1024)
 #define MEOW_HEAP_START             0x200000  /* 2MB mark - cozy cat territory */
 #define MEOW_HEAP_END               (MEOW_HEAP_START + MEOW_HEAP_SIZE_BYTES)
 
+/* Growth: extra regions are contiguous territory runs from the PMM */
+#define MEOW_HEAP_MAX_SIZE_MB       256       /* Ceiling for all regions together */
+#define MEOW_HEAP_MAX_SIZE_BYTES    (MEOW_HEAP_MAX_SIZE_MB * 1024 * 1024)
+#define MEOW_HEAP_GROW_MIN_TERRITORIES 64     /* Grow by at least 256KB at a time */
+#define MEOW_HEAP_PRESSURE_TERRITORIES 1024   /* Below 4MB free PMM memory, shrink */
+
 /* Heap configuration constants */
 #define MEOW_HEAP_MIN_BLOCK_SIZE    16        /* Minimum allocation size */
 #define MEOW_HEAP_ALIGNMENT         4         /* Memory alignment */
-#define MEOW_HEAP_MAX_ALLOC_SIZE    (MEOW_HEAP_SIZE_BYTES / 2)  /* Max single allocation */
+#define MEOW_HEAP_MAX_ALLOC_SIZE    (16 * 1024 * 1024)  /* Max single allocation */
 #define MEOW_HEAP_GUARD_PATTERN     0xDEADBEEF  /* Guard pattern for corruption detection */
 
+/* Segregated size classes: 16-byte steps below 256 bytes, powers of two above */
+#define MEOW_HEAP_SIZE_CLASSES      32        /* Must fit the non-empty class bitmap */
+#define MEOW_HEAP_SMALL_CLASS_STEP  16        /* Granularity of the small classes */
+#define MEOW_HEAP_SMALL_CLASS_LIMIT 256       /* First size served by power-of-two classes */
+#define MEOW_HEAP_SMALL_CLASSES     ((MEOW_HEAP_SMALL_CLASS_LIMIT / MEOW_HEAP_SMALL_CLASS_STEP) - 1)
+
 /* Heap block flags */
 #define MEOW_HEAP_BLOCK_FREE        0x00
 #define MEOW_HEAP_BLOCK_OCCUPIED    0x01
@@ -43,6 +55,8 @@
  * 
  * This structure represents a memory block in the heap. It contains metadata
  * about the block including size, occupancy status, and pointer to the next block.
+ * Every block is followed by a cat_memory_footer_t boundary tag, so the
+ * physical neighbours of a block are found without walking the chain.
  */
 typedef struct cat_memory_block {
     uint32_t size;                      /* Size of usable memory in this block */
@@ -52,9 +66,44 @@ typedef struct cat_memory_block {
     struct cat_memory_block* next_bed;  /* Pointer to next memory block */
     uint32_t guard_front;               /* Front guard pattern */
     /* User data follows here */
-    /* uint32_t guard_back follows user data */
+    /* cat_memory_footer_t follows user data */
 } cat_memory_block_t;
 
+/**
+ * cat_memory_footer - Boundary tag at the end of every block
+ *
+ * Mirrors the size and state of the block header so that a block being
+ * freed can look at the footer just before it and merge with its physical
+ * predecessor in constant time. The heap starts with a lone occupied
+ * footer and ends with a zero-sized occupied header, so merging never runs
+ * off either end.
+ */
+typedef struct cat_memory_footer {
+    uint32_t guard_back;                /* Back guard pattern */
+    uint32_t size;                      /* Copy of the header size */
+    uint8_t occupied;                   /* Copy of the header state */
+    uint8_t flags;                      /* Copy of the header flags */
+    uint16_t magic;                     /* Magic number for corruption detection */
+} cat_memory_footer_t;
+
+/* Per-block bookkeeping cost: header in front, boundary tag behind */
+#define MEOW_HEAP_BLOCK_OVERHEAD \
+    (sizeof(cat_memory_block_t) + sizeof(cat_memory_footer_t))
+
+/**
+ * cat_heap_class_stats - Per size-class statistics
+ *
+ * One entry per segregated free list. A hit is an allocation that was
+ * satisfied from the free list of its own class; misses had to split a
+ * block taken from a larger class.
+ */
+typedef struct cat_heap_class_stats {
+    uint32_t min_size;          /* Smallest block size kept in this class */
+    uint32_t free_blocks;       /* Blocks currently on this class free list */
+    uint32_t requests;          /* Allocations whose size maps to this class */
+    uint32_t hits;              /* Requests served from this class free list */
+} cat_heap_class_stats_t;
+
 /**
  * cat_heap_stats - Heap statistics structure
  * 
@@ -75,6 +124,11 @@ typedef struct cat_heap_stats {
     uint32_t largest_free;      /* Largest free block size */
     uint32_t smallest_free;     /* Smallest free block size */
     double fragmentation;       /* Heap fragmentation percentage */
+    uint32_t region_count;      /* Regions currently making up the heap */
+    uint32_t grow_events;       /* Regions added from the PMM */
+    uint32_t shrink_events;     /* Regions handed back to the PMM */
+    uint32_t class_bitmap;      /* Bit N set when size class N has free blocks */
+    cat_heap_class_stats_t classes[MEOW_HEAP_SIZE_CLASSES]; /* Per-class stats */
 } cat_heap_stats_t;
 
 /* ============================================================================
@@ -148,6 +202,16 @@ void* meow_heap_realloc(void* ptr, size_t new_size);
  */
 void* meow_heap_calloc(size_t count, size_t size);
 
+/**
+ * meow_heap_trim - Give fully empty trailing regions back to the PMM
+ *
+ * Called by the physical memory manager when it runs dry. The initial
+ * window at MEOW_HEAP_START is never released.
+ *
+ * @return Number of territories released
+ */
+uint32_t meow_heap_trim(void);
+
 /* ============================================================================
  * CAT HEAP STATISTICS AND MONITORING
  * ============================================================================ */
@@ -157,7 +221,8 @@ void* meow_heap_calloc(size_t count, size_t size);
  * @stats: Pointer to structure to fill with statistics
  * 
  * Retrieves detailed statistics about the current heap state including
- * memory usage, fragmentation, and allocation history.
+ * memory usage, fragmentation, allocation history and per size-class
+ * request and hit counts.
  * 
  * @return MEOW_SUCCESS on success, error code on failure
  */
@@ -167,7 +232,7 @@ meow_error_t meow_heap_get_stats(cat_heap_stats_t* stats);
  * meow_heap_print_stats - Print heap statistics to debug output
  * 
  * Prints a formatted summary of heap statistics including memory usage,
- * fragmentation, and block information.
+ * fragmentation, block information and hit rates of every used size class.
  */
 void meow_heap_print_stats(void);
 
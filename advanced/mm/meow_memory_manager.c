@@ -7,6 +7,7 @@
 #include "meow_memory_mapper.h"
 #include "meow_physical_memory.h" 
 #include "meow_heap_allocator.h"
+#include "meow_slab_allocator.h"
 #include "../../kernel/meow_util.h"
 #include "../hal/meow_hal_interface.h"
 
@@ -96,6 +97,9 @@ void get_memory_statistics(memory_stats_t* stats) {
         stats->total_territories = 0;
         stats->safe_territories = 0;
         stats->occupied_territories = 0;
+        stats->slab_caches = 0;
+        stats->slab_territories = 0;
+        stats->slab_objects = 0;
         return;
     }
 
@@ -115,6 +119,10 @@ void get_memory_statistics(memory_stats_t* stats) {
     stats->total_territories = total;
     stats->occupied_territories = occupied;
     stats->safe_territories = total - occupied;
+
+    /* Object cache statistics from the slab layer */
+    stats->slab_caches = meow_cache_get_totals(&stats->slab_territories,
+                                               &stats->slab_objects);
 }
 
 /* ============================================================================
@@ -156,7 +164,7 @@ void init_cat_memory(multiboot_info_t* multiboot_info) {
 
     /* Step 2: Initialize physical memory manager */
     meow_log(MEOW_LOG_MEOW, "Phase 2: Physical memory manager...");
-    uint32_t total_memory = get_memory_size_from_territories();
+    uint64_t total_memory = get_memory_top_from_territories();
     if (total_memory == 0) {
         meow_log(MEOW_LOG_YOWL, "No usable memory detected!");
         last_error = MM_ERROR_NO_MEMORY;
@@ -165,6 +173,12 @@ void init_cat_memory(multiboot_info_t* multiboot_info) {
 
     purr_memory_init(total_memory);
 
+    /* Paging tables come from the PMM, so paging starts right after it */
+    meow_error_t paging_result = HAL_MEMORY_OP_SAFE(init_paging, MEOW_ERROR_NOT_SUPPORTED);
+    if (paging_result != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_HISS, "Paging not enabled: %s", meow_error_to_string(paging_result));
+    }
+
     /* Step 3: Initialize cat heap (using new interface) */
     meow_log(MEOW_LOG_MEOW, "Phase 3: Cat heap allocator...");
     meow_error_t heap_result = meow_heap_init();
@@ -226,6 +240,37 @@ static uint8_t run_memory_validation_tests(void) {
         return 0;
     }
 
+    /* Test 4: Object cache round trip on a territory from the PMM */
+    meow_cache_t* test_cache = meow_cache_create("mm-selftest", 48, 16, NULL);
+    if (!test_cache) {
+        meow_log(MEOW_LOG_YOWL, "Object cache creation test failed");
+        return 0;
+    }
+    void* obj_a = meow_cache_alloc(test_cache);
+    void* obj_b = meow_cache_alloc(test_cache);
+    if (!obj_a || !obj_b || obj_a == obj_b || ((uintptr_t)obj_b & 15) != 0) {
+        meow_log(MEOW_LOG_YOWL, "Object cache allocation test failed");
+        return 0;
+    }
+    if (meow_cache_free(test_cache, obj_a) != MEOW_SUCCESS ||
+        meow_cache_free(test_cache, obj_b) != MEOW_SUCCESS ||
+        meow_cache_destroy(test_cache) != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_YOWL, "Object cache free test failed");
+        return 0;
+    }
+
+    /* Test 5: Contiguous buddy block, then cross-check lists against the bitmap */
+    uint32_t block = purr_alloc_territories(2);
+    if (!block || (block & ((4 * TERRITORY_SIZE) - 1)) != 0) {
+        meow_log(MEOW_LOG_YOWL, "Buddy allocation test failed");
+        return 0;
+    }
+    purr_free_territories(block, 2);
+    if (!purr_memory_validate()) {
+        meow_log(MEOW_LOG_YOWL, "Physical memory validation failed");
+        return 0;
+    }
+
     meow_log(MEOW_LOG_CHIRP, "Memory validation tests PASSED!");
     return 1;
 }
@@ -252,6 +297,12 @@ void display_memory_summary(void) {
     meow_printf("Heap Used: %d KB\n", current_stats.heap_used / 1024);
     meow_printf("Territories: %d total, %d safe\n",
                 current_stats.total_territories, current_stats.safe_territories);
+    meow_printf("Cat caches: %d (%d territories, %d objects)\n",
+                current_stats.slab_caches, current_stats.slab_territories,
+                current_stats.slab_objects);
+    if (current_stats.slab_caches > 0) {
+        meow_cache_print_stats();
+    }
     meow_printf("============================\n\n");
 }
 
@@ -10,6 +10,7 @@
 #include <stddef.h>
 #include "meow_physical_memory.h"    // Include for PMM functions
 #include "meow_heap_allocator.h"     // Include for heap functions
+#include "meow_slab_allocator.h"     // Include for object caches
 
 // =============================================================================
 // MEMORY MANAGEMENT CONFIGURATION
@@ -38,6 +39,9 @@ typedef struct memory_stats {
     uint32_t total_territories;
     uint32_t safe_territories;
     uint32_t occupied_territories;
+    uint32_t slab_caches;
+    uint32_t slab_territories;
+    uint32_t slab_objects;
 } memory_stats_t;
 
 // =============================================================================
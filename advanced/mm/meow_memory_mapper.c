@@ -11,7 +11,7 @@
 #define KERNEL_START 0x100000      // 1MB - where kernel cats live
 
 // Global territory database (cat's mental map)
-static cat_territory_info_t cat_territories[MAX_TERRITORIES];
+static cat_territory_info_t cat_territories[MAX_CAT_TERRITORY_ENTRIES];
 static uint32_t territory_count = 0;
 static uint64_t total_available_memory = 0;
 static cat_territory_info_t* largest_safe_territory = NULL;
@@ -62,7 +62,7 @@ void parse_multiboot_territories(multiboot_info_t* mbi) {
     
     // Parse each memory region
     while ((uint32_t)mmap < mbi->mmap_addr + mbi->mmap_length) {
-        if (territory_count >= MAX_TERRITORIES) {
+        if (territory_count >= MAX_CAT_TERRITORY_ENTRIES) {
             meow_log(MEOW_LOG_MEOW," Too many territories - cats are overwhelmed!");
             break;
         }
@@ -249,8 +249,22 @@ void print_territory_map(void) {
 }
 
 // Calculate total available territory size
-uint32_t get_memory_size_from_territories(void) {
-    return (uint32_t)total_available_memory;
+uint64_t get_memory_size_from_territories(void) {
+    return total_available_memory;
+}
+
+// End of the highest available territory (holes included below it)
+uint64_t get_memory_top_from_territories(void) {
+    uint64_t top = 0;
+
+    for (uint32_t i = 0; i < territory_count; i++) {
+        cat_territory_info_t* territory = &cat_territories[i];
+        if (territory->type == TERRITORY_TYPE_AVAILABLE && territory->safe_for_cats &&
+            territory->start_addr + territory->size > top) {
+            top = territory->start_addr + territory->size;
+        }
+    }
+    return top;
 }
 
 // Reserve special areas for important cat activities
@@ -258,10 +272,10 @@ void setup_reserved_cat_areas(void) {
     meow_log(MEOW_LOG_MEOW," Setting up special cat activity areas...");
     
     // Reserve area for territory bitmap (cats need to track their domain)
-    meow_printf(" Territory bitmap area: 0x100000 - 0x108000 (32KB)\n");
+    meow_printf(" Territory bitmap area: after the kernel, sized from RAM\n");
     
     // Reserve area for cat heap (cozy sleeping areas)
-    meow_printf("  Cat heap area: 0x200000 - 0x300000 (1MB)\n");
+    meow_printf("  Cat heap area: 0x200000 - 0x300000 (1MB, grows from PMM)\n");
     
     // These areas are managed by the purr memory manager
     meow_log(MEOW_LOG_MEOW," Special cat areas reserved and ready!");
@@ -300,3 +314,25 @@ uint32_t get_total_safe_territories(void) {
 uint64_t get_available_territory_size(void) {
     return total_available_memory;
 }
+
+// Find the territory containing an address
+cat_territory_info_t* get_territory_by_address(uint64_t addr) {
+    for (uint32_t i = 0; i < territory_count; i++) {
+        cat_territory_info_t* territory = &cat_territories[i];
+        if (addr >= territory->start_addr &&
+            addr < territory->start_addr + territory->size) {
+            return territory;
+        }
+    }
+    return NULL;
+}
+
+// Get a territory in memory map order
+cat_territory_info_t* get_territory_by_index(uint32_t index) {
+    return index < territory_count ? &cat_territories[index] : NULL;
+}
+
+// Get the number of memory map entries
+uint32_t get_territory_count(void) {
+    return territory_count;
+}
@@ -20,6 +20,9 @@
 #define TERRITORY_TYPE_ACPI_RECLAIM 3  // Special cat zones
 #define TERRITORY_TYPE_ACPI_NVS     4  // Cats stay away
 
+// Most multiboot memory maps have well under a dozen entries
+#define MAX_CAT_TERRITORY_ENTRIES   64
+
 // =============================================================================
 // CAT TERRITORY STRUCTURES
 // =============================================================================
@@ -46,7 +49,8 @@ uint8_t validate_territory_safety(uint64_t addr, uint64_t size);
 cat_territory_info_t* get_largest_territory(void);
 void mark_kernel_territory(void);
 void print_territory_map(void);
-uint32_t get_memory_size_from_territories(void);
+uint64_t get_memory_size_from_territories(void);
+uint64_t get_memory_top_from_territories(void);
 void setup_reserved_cat_areas(void);
 
 // Territory query functions
@@ -56,6 +60,7 @@ uint64_t get_available_territory_size(void);
 
 // Territory management functions
 cat_territory_info_t* get_territory_by_address(uint64_t addr);
+cat_territory_info_t* get_territory_by_index(uint32_t index);
 uint32_t get_territory_count(void);
 void validate_all_territories(void);
 
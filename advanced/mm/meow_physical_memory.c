@@ -5,7 +5,12 @@
 
 #include "meow_physical_memory.h"
 #include "meow_memory_manager.h"
+#include "meow_memory_mapper.h"
 #include "../../kernel/meow_util.h"
+#include "../../kernel/meow_lock.h"
+#include "../../kernel/meow_percpu.h"
+#include "../../kernel/meow_trace.h"
+#include "../hal/meow_hal_interface.h"
 
 // PMM Global State
 static uint32_t total_territories = 0;
@@ -15,7 +20,463 @@ static uint8_t pmm_initialized = 0;
 static uint32_t bitmap_size_bytes = 0;
 static uint32_t reserved_territories = 0;
 
-void purr_memory_init(uint32_t memory_size) {
+// Every allocation and free goes through the zones, so queue the waiters
+MEOW_LOCK_CLASS(purr_lock_class, "purr-zones");
+static meow_mcs_lock_t purr_lock = MEOW_MCS_LOCK_INIT(&purr_lock_class);
+
+// Buddy allocator state. Free blocks are linked by territory index through
+// side tables rather than through the free pages themselves, so the lists
+// never depend on a page being mapped. The bitmap keeps one bit per
+// territory (set = occupied) and is what purr_memory_validate() trusts.
+// Holes and reserved ranges in the memory map stay occupied forever.
+typedef struct purr_free_link {
+    uint32_t next;
+    uint32_t prev;
+} purr_free_link_t;
+
+typedef struct purr_free_area {
+    uint32_t head;          // First free block of this order
+    uint32_t count;         // Free blocks of this order
+} purr_free_area_t;
+
+// One buddy allocator per zone. Zone limits are 4MB aligned, so a buddy
+// block never straddles two zones.
+typedef struct purr_zone {
+    const char* name;
+    uint32_t start;                 // First territory
+    uint32_t end;                   // One past the last territory
+    uint32_t managed;               // Territories seeded from the memory map
+    uint32_t free;                  // Territories on the free lists
+    uint32_t watermark_min;
+    uint32_t watermark_low;
+    uint32_t watermark_high;
+    uint32_t lowmem_reserve;        // Kept back from higher zone fallbacks
+    uint32_t allocations;
+    uint32_t fallbacks;
+    uint32_t failures;
+    purr_free_area_t free_areas[PURR_ORDER_COUNT];
+    uint32_t free_order_mask;       // Bit N set when order N has free blocks
+} purr_zone_t;
+
+static purr_zone_t purr_zones[PURR_ZONE_COUNT] = {
+    [PURR_ZONE_DMA] = { .name = "DMA" },
+    [PURR_ZONE_NORMAL] = { .name = "Normal" },
+    [PURR_ZONE_HIGH] = { .name = "High" },
+};
+static purr_free_link_t* territory_links = NULL;  // Valid for free block heads and cached territories
+static uint8_t* territory_order = NULL;           // Order of a free block head, PURR_ORDER_PCP, else PURR_ORDER_NONE
+
+// Per-CPU page cache. Cached territories are occupied as far as the zones
+// and the bitmap are concerned and are chained through territory_links:
+// the head is the hot end, where frees go and allocations come from, the
+// tail the cold end that drains first. Only touched by its own CPU with
+// interrupts off, so no lock. head and tail mean nothing while count is 0,
+// which is how a zeroed per-CPU copy starts.
+typedef struct purr_pcp {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t count;
+    uint32_t hits;
+    uint32_t refills;
+    uint32_t drains;
+} purr_pcp_t;
+
+static MEOW_DEFINE_PER_CPU(purr_pcp_t, purr_pcp);
+
+// A reserved range of territories [start, end) kept out of the free lists
+typedef struct purr_range {
+    uint32_t start;
+    uint32_t end;
+} purr_range_t;
+
+// Summary level: bit W set while bitmap word W has at least one free territory.
+// One summary word covers PURR_SUMMARY_SPAN territories, so a scan over
+// occupied memory skips 4MB per word read instead of 128KB.
+static uint32_t* territory_summary = NULL;
+static uint32_t summary_size_bytes = 0;
+
+#define BITMAP_TEST(t)  (territory_bitmap[(t) / 32] & (1u << ((t) % 32)))
+
+// Set (occupy) the territories [t, t + count), one word at a time
+static void bitmap_set_range_internal(uint32_t t, uint32_t count) {
+    while (count > 0) {
+        uint32_t word = t / 32;
+        uint32_t bit = t % 32;
+        uint32_t span = 32 - bit < count ? 32 - bit : count;
+        uint32_t mask = span == 32 ? 0xFFFFFFFF : ((1u << span) - 1) << bit;
+
+        territory_bitmap[word] |= mask;
+        if (territory_bitmap[word] == 0xFFFFFFFF) {
+            territory_summary[word / 32] &= ~(1u << (word % 32));
+        }
+        t += span;
+        count -= span;
+    }
+}
+
+// Clear (free) the territories [t, t + count), one word at a time
+static void bitmap_clear_range_internal(uint32_t t, uint32_t count) {
+    while (count > 0) {
+        uint32_t word = t / 32;
+        uint32_t bit = t % 32;
+        uint32_t span = 32 - bit < count ? 32 - bit : count;
+        uint32_t mask = span == 32 ? 0xFFFFFFFF : ((1u << span) - 1) << bit;
+
+        territory_bitmap[word] &= ~mask;
+        territory_summary[word / 32] |= (1u << (word % 32));
+        t += span;
+        count -= span;
+    }
+}
+
+// Find the first clear bit at or after `t`. The rest of the starting word is
+// checked directly; past it the summary level points at the next word that
+// has a free territory. The tail past total_territories is always set.
+static uint32_t next_free_territory_internal(uint32_t t) {
+    uint32_t bitmap_entries = (total_territories + 31) / 32;
+    uint32_t summary_entries = (bitmap_entries + 31) / 32;
+    uint32_t word = t / 32;
+    uint32_t bits = territory_bitmap[word] | ((1u << (t % 32)) - 1);
+
+    if (bits != 0xFFFFFFFF) {
+        return word * 32 + __builtin_ctz(~bits);
+    }
+
+    if (++word >= bitmap_entries) {
+        return total_territories;
+    }
+    uint32_t index = word / 32;
+    uint32_t summary = territory_summary[index] & ~((1u << (word % 32)) - 1);
+    while (summary == 0) {
+        if (++index >= summary_entries) {
+            return total_territories;
+        }
+        summary = territory_summary[index];
+    }
+    word = index * 32 + __builtin_ctz(summary);
+    return word * 32 + __builtin_ctz(~territory_bitmap[word]);
+}
+
+// Find the first set bit at or after `t`, skipping empty words at a time.
+static uint32_t next_occupied_territory_internal(uint32_t t) {
+    uint32_t bitmap_entries = (total_territories + 31) / 32;
+    uint32_t word = t / 32;
+    uint32_t bits = territory_bitmap[word] & ~((1u << (t % 32)) - 1);
+
+    while (bits == 0) {
+        if (++word >= bitmap_entries) {
+            return total_territories;
+        }
+        bits = territory_bitmap[word];
+    }
+    uint32_t found = word * 32 + __builtin_ctz(bits);
+    return found < total_territories ? found : total_territories;
+}
+
+static inline purr_zone_t* zone_of_internal(uint32_t t) {
+    if (t < PURR_ZONE_DMA_LIMIT / TERRITORY_SIZE) {
+        return &purr_zones[PURR_ZONE_DMA];
+    }
+    if (t < PURR_ZONE_NORMAL_LIMIT / TERRITORY_SIZE) {
+        return &purr_zones[PURR_ZONE_NORMAL];
+    }
+    return &purr_zones[PURR_ZONE_HIGH];
+}
+
+static void free_area_push_internal(purr_zone_t* zone, uint32_t t, uint32_t order) {
+    purr_free_area_t* area = &zone->free_areas[order];
+
+    territory_links[t].prev = PURR_NO_TERRITORY;
+    territory_links[t].next = area->head;
+    if (area->head != PURR_NO_TERRITORY) {
+        territory_links[area->head].prev = t;
+    }
+    area->head = t;
+    area->count++;
+    territory_order[t] = (uint8_t)order;
+    zone->free_order_mask |= (1u << order);
+}
+
+static void free_area_remove_internal(purr_zone_t* zone, uint32_t t, uint32_t order) {
+    purr_free_area_t* area = &zone->free_areas[order];
+    purr_free_link_t* link = &territory_links[t];
+
+    if (link->prev != PURR_NO_TERRITORY) {
+        territory_links[link->prev].next = link->next;
+    } else {
+        area->head = link->next;
+    }
+    if (link->next != PURR_NO_TERRITORY) {
+        territory_links[link->next].prev = link->prev;
+    }
+    area->count--;
+    territory_order[t] = PURR_ORDER_NONE;
+    if (area->head == PURR_NO_TERRITORY) {
+        zone->free_order_mask &= ~(1u << order);
+    }
+}
+
+// Give the block [t, t + 2^order) back, merging with free buddies
+static void buddy_free_internal(uint32_t t, uint32_t order) {
+    purr_zone_t* zone = zone_of_internal(t);
+
+    bitmap_clear_range_internal(t, 1u << order);
+    occupied_territories -= (1u << order);
+    zone->free += (1u << order);
+
+    while (order < PURR_MAX_ORDER) {
+        uint32_t buddy = t ^ (1u << order);
+        if (buddy + (1u << order) > total_territories || territory_order[buddy] != order) {
+            break;
+        }
+        free_area_remove_internal(zone, buddy, order);
+        t &= ~(1u << order);
+        order++;
+    }
+    free_area_push_internal(zone, t, order);
+}
+
+// Hand the free range [start, end) to the buddy lists as aligned blocks
+static void buddy_free_range_internal(uint32_t start, uint32_t end) {
+    while (start < end) {
+        uint32_t order = start ? __builtin_ctz(start) : PURR_MAX_ORDER;
+        if (order > PURR_MAX_ORDER) {
+            order = PURR_MAX_ORDER;
+        }
+        while ((1u << order) > end - start) {
+            order--;
+        }
+        buddy_free_internal(start, order);
+        start += (1u << order);
+    }
+}
+
+// Seed [start, end) minus the sorted reserved ranges into the free lists
+static void seed_free_range_internal(uint32_t start, uint32_t end,
+                                     const purr_range_t* reserved, uint32_t reserved_count) {
+    for (uint32_t i = 0; i < reserved_count && start < end; i++) {
+        if (reserved[i].end <= start || reserved[i].start >= end) {
+            continue;
+        }
+        if (reserved[i].start > start) {
+            buddy_free_range_internal(start, reserved[i].start);
+        }
+        start = reserved[i].end;
+    }
+    if (start < end) {
+        buddy_free_range_internal(start, end);
+    }
+}
+
+// Clip the zones to the managed span and derive their watermarks
+static void setup_zones_internal(void) {
+    static const uint32_t limits[PURR_ZONE_COUNT] = {
+        PURR_ZONE_DMA_LIMIT / TERRITORY_SIZE,
+        PURR_ZONE_NORMAL_LIMIT / TERRITORY_SIZE,
+        PURR_MAX_TERRITORIES,
+    };
+    uint32_t start = 0;
+
+    for (uint32_t z = 0; z < PURR_ZONE_COUNT; z++) {
+        purr_zone_t* zone = &purr_zones[z];
+        uint32_t end = limits[z] < total_territories ? limits[z] : total_territories;
+
+        zone->start = start;
+        zone->end = end > start ? end : start;
+        zone->managed = 0;
+        zone->free = 0;
+        zone->allocations = 0;
+        zone->fallbacks = 0;
+        zone->failures = 0;
+        for (uint32_t order = 0; order < PURR_ORDER_COUNT; order++) {
+            zone->free_areas[order].head = PURR_NO_TERRITORY;
+            zone->free_areas[order].count = 0;
+        }
+        zone->free_order_mask = 0;
+        start = zone->end;
+    }
+}
+
+static void setup_watermarks_internal(void) {
+    uint32_t higher_managed = 0;
+
+    for (int z = PURR_ZONE_COUNT - 1; z >= 0; z--) {
+        purr_zone_t* zone = &purr_zones[z];
+
+        // Everything seeded is free at this point
+        zone->managed = zone->free;
+        if (zone->managed == 0) {
+            zone->watermark_min = zone->watermark_low = zone->watermark_high = 0;
+            zone->lowmem_reserve = 0;
+            continue;
+        }
+
+        uint32_t min = zone->managed / PURR_WATERMARK_RATIO;
+        if (min < PURR_WATERMARK_FLOOR) min = PURR_WATERMARK_FLOOR;
+        if (min > PURR_WATERMARK_CEILING) min = PURR_WATERMARK_CEILING;
+        zone->watermark_min = min;
+        zone->watermark_low = min + min / 4;
+        zone->watermark_high = min + min / 2;
+
+        // Never let fallbacks from above claim more than half of a zone
+        zone->lowmem_reserve = higher_managed / PURR_LOWMEM_RESERVE_RATIO;
+        if (zone->lowmem_reserve > zone->managed / 2) {
+            zone->lowmem_reserve = zone->managed / 2;
+        }
+        higher_managed += zone->managed;
+    }
+}
+
+// Take a 2^order block out of one zone, splitting a larger one if needed
+static uint32_t zone_alloc_internal(purr_zone_t* zone, uint32_t order) {
+    uint32_t candidates = zone->free_order_mask & ~((1u << order) - 1);
+    if (!candidates) {
+        return PURR_NO_TERRITORY;
+    }
+
+    uint32_t found = __builtin_ctz(candidates);
+    uint32_t t = zone->free_areas[found].head;
+    free_area_remove_internal(zone, t, found);
+
+    // Split down, returning upper halves to the lower orders
+    while (found > order) {
+        found--;
+        free_area_push_internal(zone, t + (1u << found), found);
+    }
+
+    bitmap_set_range_internal(t, 1u << order);
+    occupied_territories += (1u << order);
+    zone->free -= (1u << order);
+    zone->allocations++;
+    return t;
+}
+
+// Zones a request may use, preferred zone first
+static uint32_t zone_list_internal(uint32_t flags, purr_zone_t** zones) {
+    uint32_t count = 0;
+
+    if (flags & PURR_ALLOC_DMA) {
+        zones[count++] = &purr_zones[PURR_ZONE_DMA];
+        return count;
+    }
+    if (flags & PURR_ALLOC_HIGH) {
+        zones[count++] = &purr_zones[PURR_ZONE_HIGH];
+    }
+    zones[count++] = &purr_zones[PURR_ZONE_NORMAL];
+    zones[count++] = &purr_zones[PURR_ZONE_DMA];
+    return count;
+}
+
+// Free in the zones, or parked in some CPU's page cache
+static inline uint8_t territory_is_free_internal(uint32_t t) {
+    return !BITMAP_TEST(t) || territory_order[t] == PURR_ORDER_PCP;
+}
+
+static void pcp_push_internal(purr_pcp_t* pcp, uint32_t t, uint8_t cold) {
+    purr_free_link_t* link = &territory_links[t];
+
+    territory_order[t] = PURR_ORDER_PCP;
+    if (pcp->count == 0) {
+        link->prev = PURR_NO_TERRITORY;
+        link->next = PURR_NO_TERRITORY;
+        pcp->head = t;
+        pcp->tail = t;
+    } else if (cold) {
+        link->prev = pcp->tail;
+        link->next = PURR_NO_TERRITORY;
+        territory_links[pcp->tail].next = t;
+        pcp->tail = t;
+    } else {
+        link->prev = PURR_NO_TERRITORY;
+        link->next = pcp->head;
+        territory_links[pcp->head].prev = t;
+        pcp->head = t;
+    }
+    pcp->count++;
+}
+
+static uint32_t pcp_pop_internal(purr_pcp_t* pcp, uint8_t cold) {
+    uint32_t t = cold ? pcp->tail : pcp->head;
+
+    pcp->count--;
+    if (pcp->count > 0) {
+        if (cold) {
+            pcp->tail = territory_links[t].prev;
+            territory_links[pcp->tail].next = PURR_NO_TERRITORY;
+        } else {
+            pcp->head = territory_links[t].next;
+            territory_links[pcp->head].prev = PURR_NO_TERRITORY;
+        }
+    }
+    territory_order[t] = PURR_ORDER_NONE;
+    return t;
+}
+
+// Take up to a batch of single territories from the default zones under
+// one lock round trip, keeping above the low watermarks. Interrupts off.
+static void pcp_refill_internal(purr_pcp_t* pcp) {
+    purr_zone_t* zones[PURR_ZONE_COUNT];
+    uint32_t zone_count = zone_list_internal(0, zones);
+    meow_mcs_node_t node;
+
+    meow_mcs_lock(&purr_lock, &node);
+    for (uint32_t i = 0; i < zone_count && pcp->count < PURR_PCP_BATCH; i++) {
+        purr_zone_t* zone = zones[i];
+        uint32_t mark = zone->watermark_low + (i > 0 ? zone->lowmem_reserve : 0);
+        while (pcp->count < PURR_PCP_BATCH && zone->free > mark) {
+            uint32_t t = zone_alloc_internal(zone, 0);
+            if (t == PURR_NO_TERRITORY) {
+                break;
+            }
+            if (i > 0) {
+                zone->fallbacks++;
+            }
+            // Fresh from the zones, so not in this CPU's cache
+            pcp_push_internal(pcp, t, 1);
+        }
+    }
+    meow_mcs_unlock(&purr_lock, &node);
+    pcp->refills++;
+}
+
+// Hand up to @count of the coldest cached territories back. Interrupts off.
+static void pcp_drain_internal(purr_pcp_t* pcp, uint32_t count) {
+    meow_mcs_node_t node;
+
+    meow_mcs_lock(&purr_lock, &node);
+    while (count-- > 0 && pcp->count > 0) {
+        buddy_free_internal(pcp_pop_internal(pcp, 1), 0);
+    }
+    meow_mcs_unlock(&purr_lock, &node);
+    pcp->drains++;
+}
+
+static void pcp_free_internal(uint32_t territory, uint8_t cold) {
+    uint32_t irq_flags = meow_irq_save();
+    if (territory_is_free_internal(territory)) {
+        meow_irq_restore(irq_flags);
+        meow_log(MEOW_LOG_HISS," Territory %d already free", territory);
+        return;
+    }
+
+    purr_pcp_t* pcp = this_cpu_ptr(&purr_pcp);
+    pcp_push_internal(pcp, territory, cold);
+    MEOW_TRACE("pmm: freed territory %u to the CPU cache (cold: %u)", territory, cold);
+    if (pcp->count > PURR_PCP_HIGH) {
+        pcp_drain_internal(pcp, PURR_PCP_BATCH);
+    }
+    meow_irq_restore(irq_flags);
+}
+
+// Is the range [start, end) inside one available memory map entry?
+static uint8_t range_is_available_internal(uint64_t start, uint64_t end) {
+    cat_territory_info_t* territory = get_territory_by_address(start);
+
+    return territory && territory->type == TERRITORY_TYPE_AVAILABLE &&
+           territory->safe_for_cats && end <= territory->start_addr + territory->size;
+}
+
+void purr_memory_init(uint64_t memory_size) {
     meow_log(MEOW_LOG_CHIRP,"==== Purr Memory Manager initializing... ====");
 
     // SAFETY: Validate input parameters
@@ -24,71 +485,122 @@ void purr_memory_init(uint32_t memory_size) {
         return;
     }
     if (memory_size < (8 * 1024 * 1024)) { // Less than 8MB
-        meow_log(MEOW_LOG_YOWL," Cannot initialize PMM: insufficient memory (%d bytes)", memory_size);
+        meow_log(MEOW_LOG_YOWL," Cannot initialize PMM: insufficient memory (%u bytes)",
+                  (uint32_t)memory_size);
         return;
     }
 
-    // Calculate territories (4KB pages)
-    total_territories = memory_size / TERRITORY_SIZE;
-    if (total_territories == 0) {
-        meow_log(MEOW_LOG_YOWL," Cannot initialize PMM: zero territories calculated!");
-        return;
-    }
-    if (total_territories > MAX_TERRITORIES) {
-        meow_log(MEOW_LOG_HISS," Memory size too large, capping at %d territories", MAX_TERRITORIES);
-        total_territories = MAX_TERRITORIES;
+    // Calculate territories (4KB pages); territory addresses are 32-bit
+    if (memory_size > (uint64_t)PURR_MAX_TERRITORIES * TERRITORY_SIZE) {
+        meow_log(MEOW_LOG_HISS," Memory above 4GB is not addressable, using the first 4GB");
+        memory_size = (uint64_t)PURR_MAX_TERRITORIES * TERRITORY_SIZE;
     }
-    meow_log(MEOW_LOG_CHIRP," Total territories calculated: %d (memory: %d MB)",
-              total_territories, memory_size / (1024 * 1024));
+    total_territories = (uint32_t)(memory_size / TERRITORY_SIZE);
+    meow_log(MEOW_LOG_CHIRP," Total territories calculated: %u (memory: %u MB)",
+              total_territories, total_territories / (1024 * 1024 / TERRITORY_SIZE));
 
-    // Calculate bitmap size
-    bitmap_size_bytes = ((total_territories + 31) / 32) * sizeof(uint32_t);
-    meow_log(MEOW_LOG_CHIRP,"Bitmap size needed: %d bytes (%d KB)",
-              bitmap_size_bytes, bitmap_size_bytes / 1024);
+    // Every table is sized from the detected RAM
+    uint32_t bitmap_entries = (total_territories + 31) / 32;
+    uint32_t summary_entries = (bitmap_entries + 31) / 32;
+    bitmap_size_bytes = bitmap_entries * sizeof(uint32_t);
+    summary_size_bytes = summary_entries * sizeof(uint32_t);
+    uint32_t links_size_bytes = total_territories * sizeof(purr_free_link_t);
+    uint32_t order_size_bytes = total_territories * sizeof(uint8_t);
+    uint32_t tables_size = bitmap_size_bytes + summary_size_bytes +
+                           links_size_bytes + order_size_bytes;
+    meow_log(MEOW_LOG_CHIRP,"Bitmap size needed: %u bytes (%u KB), summary %u bytes",
+              bitmap_size_bytes, bitmap_size_bytes / 1024, summary_size_bytes);
 
-    // Determine safe location for bitmap
+    // Determine safe location for the tables. They go right after the kernel
+    // when they fit below the heap's initial window, else right above it.
     extern char _kernel_end;
     uint32_t kernel_end = (uint32_t)&_kernel_end;
-    uint32_t bitmap_start = (kernel_end + 0x1000 - 1) & ~(0x1000 - 1);  // Align to 4KB
-    bitmap_start += 0x10000;  // Add 64KB safety margin
-    territory_bitmap = (uint32_t*)bitmap_start;
+    uint32_t kernel_reserved_end = (kernel_end + 0x1000 - 1) & ~(0x1000 - 1);  // Align to 4KB
+    kernel_reserved_end += 0x10000;  // Add 64KB safety margin
+    uint32_t bitmap_start = kernel_reserved_end;
+    if (bitmap_start < MEOW_HEAP_END && bitmap_start + tables_size > MEOW_HEAP_START) {
+        bitmap_start = MEOW_HEAP_END;
+    }
     meow_log(MEOW_LOG_CHIRP," Kernel ends at: 0x%x", kernel_end);
-    meow_log(MEOW_LOG_CHIRP," Bitmap placed at: 0x%x - 0x%x (%d bytes)",
-              bitmap_start, bitmap_start + bitmap_size_bytes, bitmap_size_bytes);
 
-    // SAFETY: Verify bitmap does not exceed physical RAM
-    uint64_t end_addr = (uint64_t)bitmap_start + bitmap_size_bytes;
+    uint32_t summary_start = bitmap_start + bitmap_size_bytes;
+    uint32_t links_start = summary_start + summary_size_bytes;
+    uint32_t order_start = links_start + links_size_bytes;
+    territory_bitmap = (uint32_t*)bitmap_start;
+    territory_summary = (uint32_t*)summary_start;
+    territory_links = (purr_free_link_t*)links_start;
+    territory_order = (uint8_t*)order_start;
+    meow_log(MEOW_LOG_CHIRP," Bitmap placed at: 0x%x - 0x%x (%u bytes)",
+              bitmap_start, links_start, bitmap_size_bytes + summary_size_bytes);
+    meow_log(MEOW_LOG_CHIRP," Buddy tables at: 0x%x - 0x%x (%u bytes)",
+              links_start, order_start + order_size_bytes, links_size_bytes + order_size_bytes);
+
+    // SAFETY: Verify the tables do not exceed physical RAM
+    uint64_t end_addr = (uint64_t)bitmap_start + tables_size;
     if (end_addr > memory_size) {
-        meow_log(MEOW_LOG_YOWL," Bitmap would extend beyond RAM! Start: 0x%x, Size: %d, RAM: %d",
-                   bitmap_start, bitmap_size_bytes, memory_size);
+        meow_log(MEOW_LOG_YOWL," Tables would extend beyond RAM! Start: 0x%x, Size: %u, RAM: %u MB",
+                   bitmap_start, tables_size, (uint32_t)(memory_size / (1024 * 1024)));
         return;
     }
 
-    // Calculate number of bitmap entries
-    uint32_t bitmap_entries = (total_territories + 31) / 32;
-
-    // Determine how many territories to reserve (all before bitmap)
-    uint32_t first_free_addr = bitmap_start + bitmap_size_bytes;
-    reserved_territories = first_free_addr / TERRITORY_SIZE;
-    if (reserved_territories > total_territories) {
-        reserved_territories = total_territories;
+    if (!range_is_available_internal(bitmap_start, end_addr)) {
+        meow_log(MEOW_LOG_YOWL," Tables at 0x%x - 0x%x are not in available RAM!",
+                   bitmap_start, (uint32_t)end_addr);
+        return;
     }
-    meow_log(MEOW_LOG_CHIRP," Reserving %u territories (addresses < 0x%x)",
-              reserved_territories, first_free_addr);
 
-    // Initialize bitmap: mark all as occupied
+    // Initialize bitmap: mark all as occupied, no word has a free territory
     for (uint32_t i = 0; i < bitmap_entries; i++) {
         territory_bitmap[i] = 0xFFFFFFFF;
     }
+    for (uint32_t i = 0; i < summary_entries; i++) {
+        territory_summary[i] = 0;
+    }
     occupied_territories = total_territories;
+    for (uint32_t t = 0; t < total_territories; t++) {
+        territory_order[t] = PURR_ORDER_NONE;
+    }
+    setup_zones_internal();
 
-    // Mark territories after reserved region as free
-    for (uint32_t t = reserved_territories; t < total_territories; t++) {
-        uint32_t idx = t / 32;
-        uint32_t bit = t % 32;
-        territory_bitmap[idx] &= ~(1 << bit);
-        occupied_territories--;
+    // Keep the kernel, the tables and the heap's initial window, which is
+    // carved by hand, out of the free lists. Sorted by start.
+    uint32_t tables_first = bitmap_start / TERRITORY_SIZE;
+    uint32_t tables_last = (uint32_t)((end_addr + TERRITORY_SIZE - 1) / TERRITORY_SIZE);
+    purr_range_t reserved[3];
+    reserved[0].start = 0;
+    reserved[0].end = kernel_reserved_end / TERRITORY_SIZE;
+    reserved[1].start = MEOW_HEAP_START / TERRITORY_SIZE;
+    reserved[1].end = MEOW_HEAP_END / TERRITORY_SIZE;
+    reserved[2].start = tables_first;
+    reserved[2].end = tables_last;
+    if (tables_first < reserved[1].start) {
+        reserved[2] = reserved[1];
+        reserved[1].start = tables_first;
+        reserved[1].end = tables_last;
     }
+    reserved_territories = reserved[0].end + (reserved[1].end - reserved[1].start) +
+                           (reserved[2].end - reserved[2].start);
+    meow_log(MEOW_LOG_CHIRP," Reserving %u territories for kernel, tables and heap window",
+              reserved_territories);
+
+    // Only whole territories of available RAM go to the zones; holes,
+    // firmware and ACPI ranges stay occupied
+    for (uint32_t i = 0; i < get_territory_count(); i++) {
+        cat_territory_info_t* territory = get_territory_by_index(i);
+        if (territory->type != TERRITORY_TYPE_AVAILABLE || !territory->safe_for_cats) {
+            continue;
+        }
+
+        uint64_t first = (territory->start_addr + TERRITORY_SIZE - 1) / TERRITORY_SIZE;
+        uint64_t last = (territory->start_addr + territory->size) / TERRITORY_SIZE;
+        if (last > total_territories) last = total_territories;
+        if (first >= last) {
+            continue;
+        }
+        seed_free_range_internal((uint32_t)first, (uint32_t)last, reserved, 3);
+    }
+    setup_watermarks_internal();
+    meow_log(MEOW_LOG_CHIRP," Reserved heap window 0x%x - 0x%x", MEOW_HEAP_START, MEOW_HEAP_END);
 
     pmm_initialized = 1;
     meow_log(MEOW_LOG_CHIRP," Purr Memory Manager initialized successfully!");
@@ -108,81 +620,294 @@ void purr_status(void) {
     meow_log(MEOW_LOG_CHIRP,"Free territories: %d", total_territories - occupied_territories);
     meow_log(MEOW_LOG_CHIRP,"Bitmap location: 0x%x", (uint32_t)territory_bitmap);
     meow_log(MEOW_LOG_CHIRP,"Bitmap size: %d bytes", bitmap_size_bytes);
+    meow_log(MEOW_LOG_CHIRP,"Summary size: %d bytes", summary_size_bytes);
     meow_log(MEOW_LOG_CHIRP,"Memory utilization: %d%%", 
               total_territories > 0 ? (occupied_territories * 100 / total_territories) : 0);
+    for (uint32_t z = 0; z < PURR_ZONE_COUNT; z++) {
+        purr_zone_t* zone = &purr_zones[z];
+        if (zone->start == zone->end) {
+            continue;
+        }
+        meow_log(MEOW_LOG_CHIRP,"Zone %s: 0x%x - 0x%x, %u managed, %u free (min %u low %u high %u)",
+                  zone->name, zone->start * TERRITORY_SIZE, zone->end * TERRITORY_SIZE - 1,
+                  zone->managed, zone->free, zone->watermark_min, zone->watermark_low,
+                  zone->watermark_high);
+    }
+    uint32_t cpus = HAL_CPU_OP_SAFE(get_cpu_count, 1);
+    for (uint32_t cpu = 0; cpu < cpus && cpu < MEOW_PERCPU_MAX_CPUS; cpu++) {
+        const purr_pcp_t* pcp = per_cpu_ptr(&purr_pcp, cpu);
+        meow_log(MEOW_LOG_CHIRP,"CPU %u page cache: %u cached, %u hits, %u refills, %u drains",
+                  cpu, pcp->count, pcp->hits, pcp->refills, pcp->drains);
+    }
     meow_log(MEOW_LOG_CHIRP,"====================================");
 }
 
-uint32_t purr_alloc_territory(void) {
+uint32_t purr_alloc_territories(uint32_t order) {
+    return purr_alloc_territories_flags(order, 0);
+}
+
+uint32_t purr_alloc_territories_flags(uint32_t order, uint32_t flags) {
     if (!pmm_initialized) {
         meow_log(MEOW_LOG_YOWL," Cannot allocate: PMM not initialized!!!!");
         return 0;
     }
-    if (occupied_territories >= total_territories) {
-        meow_log(MEOW_LOG_HISS," No free territories available!!!!");
+    if (order > PURR_MAX_ORDER) {
+        meow_log(MEOW_LOG_YOWL," Territory order %u too large (max: %u)", order, PURR_MAX_ORDER);
         return 0;
     }
 
-    // Start search from reserved_territories, not zero
-    uint32_t bitmap_entries = (total_territories + 31) / 32;
-    for (uint32_t t = reserved_territories; t < total_territories; t++) {
-        uint32_t idx = t / 32;
-        uint32_t bit = t % 32;
+    // Single territories from the default zones come from this CPU's cache
+    if (order == 0 && (flags & ~PURR_ALLOC_COLD) == 0) {
+        uint32_t irq_flags = meow_irq_save();
+        purr_pcp_t* pcp = this_cpu_ptr(&purr_pcp);
+        if (pcp->count == 0) {
+            pcp_refill_internal(pcp);
+        }
+        if (pcp->count > 0) {
+            uint32_t t = pcp_pop_internal(pcp, (flags & PURR_ALLOC_COLD) != 0);
+            pcp->hits++;
+            MEOW_TRACE("pmm: allocated territory %u from the CPU cache (%u left)",
+                       t, pcp->count);
+            meow_irq_restore(irq_flags);
+            return t * TERRITORY_SIZE;
+        }
+        meow_irq_restore(irq_flags);
+        // Down to the low watermarks; the slow path may go deeper
+    }
+    flags &= ~PURR_ALLOC_COLD;
+
+    purr_zone_t* zones[PURR_ZONE_COUNT];
+    uint32_t zone_count = zone_list_internal(flags, zones);
+
+    // First pass stays above the low watermarks, the second one (after the
+    // heap gave back what it could) may dig down to the min watermarks.
+    // Lower zones only take a higher zone's request above their reserve.
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        meow_mcs_node_t node;
+        uint32_t lock_flags = meow_mcs_lock_irqsave(&purr_lock, &node);
+        for (uint32_t i = 0; i < zone_count; i++) {
+            purr_zone_t* zone = zones[i];
+            uint32_t mark = pass == 0 ? zone->watermark_low : zone->watermark_min;
+            if (i > 0) {
+                mark += zone->lowmem_reserve;
+            }
+            if (zone->free < (1u << order) + mark) {
+                continue;
+            }
 
-	// Only examine bits that were marked free
-        if (!(territory_bitmap[idx] & (1 << bit))) {
-            // Mark as occupied
-            territory_bitmap[idx] |= (1 << bit);
-            occupied_territories++;
+            uint32_t t = zone_alloc_internal(zone, order);
+            if (t == PURR_NO_TERRITORY) {
+                continue;
+            }
+            if (i > 0) {
+                zone->fallbacks++;
+            }
+            meow_mcs_unlock_irqrestore(&purr_lock, &node, lock_flags);
 
             uint32_t physical_address = t * TERRITORY_SIZE;
-            meow_log(MEOW_LOG_MEOW," Allocated territory %d (physical: 0x%x)", t, physical_address);
+            MEOW_TRACE("pmm: allocated territory %u order %u from %s (physical: 0x%x)",
+                       t, order, (uint32_t)zone->name, physical_address);
             return physical_address;
         }
+        if (pass == 1) {
+            zones[0]->failures++;
+        }
+        meow_mcs_unlock_irqrestore(&purr_lock, &node, lock_flags);
+
+        // The heap calls back into the PMM, so trim without the lock.
+        // Other CPUs' caches stay put; they would need an IPI each.
+        if (pass == 0) {
+            purr_drain_cpu_cache();
+            meow_heap_trim();
+        }
     }
 
-    meow_log(MEOW_LOG_HISS,"No free territories found past reserved region");
+    meow_log(MEOW_LOG_HISS," No free territories of order %u in zone %s!!!!",
+              order, zones[0]->name);
     return 0;
 }
 
-void purr_free_territory(uint32_t physical_address) {
+void purr_free_territories(uint32_t physical_address, uint32_t order) {
     if (!pmm_initialized) {
         meow_log(MEOW_LOG_YOWL," Cannot free: PMM not initialized");
         return;
     }
-    
-    if (physical_address == 0) {
-        meow_log(MEOW_LOG_HISS," Attempting to free NULL physical address");
+
+    uint32_t territory = physical_address / TERRITORY_SIZE;
+    if (physical_address == 0 || order > PURR_MAX_ORDER ||
+        (physical_address & (TERRITORY_SIZE - 1)) != 0 ||
+        (territory & ((1u << order) - 1)) != 0 ||
+        territory + (1u << order) > total_territories) {
+        meow_log(MEOW_LOG_YOWL," Bad territory block 0x%x order %u", physical_address, order);
         return;
     }
-    
+
+    if (order == 0) {
+        pcp_free_internal(territory, 0);
+        return;
+    }
+
+    // Every territory of the block must still be occupied
+    meow_mcs_node_t node;
+    uint32_t lock_flags = meow_mcs_lock_irqsave(&purr_lock, &node);
+    for (uint32_t i = 0; i < (1u << order); i++) {
+        if (territory_is_free_internal(territory + i)) {
+            meow_mcs_unlock_irqrestore(&purr_lock, &node, lock_flags);
+            meow_log(MEOW_LOG_HISS," Territory %d already free", territory + i);
+            return;
+        }
+    }
+
+    buddy_free_internal(territory, order);
+    meow_mcs_unlock_irqrestore(&purr_lock, &node, lock_flags);
+    MEOW_TRACE("pmm: freed territory %u order %u (physical: 0x%x)",
+               territory, order, physical_address);
+}
+
+uint32_t purr_alloc_territory(void) {
+    return purr_alloc_territories(0);
+}
+
+void purr_free_territory(uint32_t physical_address) {
+    purr_free_territories(physical_address, 0);
+}
+
+void purr_free_territory_cold(uint32_t physical_address) {
+    if (!pmm_initialized) {
+        meow_log(MEOW_LOG_YOWL," Cannot free: PMM not initialized");
+        return;
+    }
+
     uint32_t territory = physical_address / TERRITORY_SIZE;
-    
-    if (territory >= total_territories) {
-        meow_log(MEOW_LOG_YOWL," Territory %d out of range (max: %d)", territory, total_territories - 1);
+    if (physical_address == 0 || (physical_address & (TERRITORY_SIZE - 1)) != 0 ||
+        territory >= total_territories) {
+        meow_log(MEOW_LOG_YOWL," Bad territory 0x%x", physical_address);
         return;
     }
-    
-    uint32_t bitmap_index = territory / 32;
-    uint32_t bit_position = territory % 32;
-    
-    uint32_t bitmap_entries = (total_territories + 31) / 32;
-    if (bitmap_index >= bitmap_entries) {
-        meow_log(MEOW_LOG_YOWL," Bitmap index %d out of range (max: %d)", bitmap_index, bitmap_entries - 1);
+    pcp_free_internal(territory, 1);
+}
+
+void purr_drain_cpu_cache(void) {
+    if (!pmm_initialized) {
         return;
     }
-    
-    // Check if already free
-    if (!(territory_bitmap[bitmap_index] & (1 << bit_position))) {
-        meow_log(MEOW_LOG_HISS," Territory %d already free", territory);
+
+    uint32_t irq_flags = meow_irq_save();
+    purr_pcp_t* pcp = this_cpu_ptr(&purr_pcp);
+    if (pcp->count > 0) {
+        pcp_drain_internal(pcp, pcp->count);
+    }
+    meow_irq_restore(irq_flags);
+}
+
+// Take `blocks` adjacent free max-order blocks out of one zone for a run
+// longer than the buddy lists can hand out. Max-order blocks never merge,
+// so each one is a free list head of its own. Called with purr_lock held.
+static uint32_t zone_alloc_blocks_internal(purr_zone_t* zone, uint32_t blocks, uint32_t mark) {
+    uint32_t block_size = 1u << PURR_MAX_ORDER;
+    uint32_t needed = blocks * block_size;
+    uint32_t first = (zone->start + block_size - 1) & ~(block_size - 1);
+    uint32_t found = 0;
+
+    if (zone->free < needed + mark) {
+        return PURR_NO_TERRITORY;
+    }
+
+    for (uint32_t t = first; t + block_size <= zone->end && found < blocks; t += block_size) {
+        found = territory_order[t] == PURR_MAX_ORDER ? found + 1 : 0;
+        if (found == blocks) {
+            first = t + block_size - needed;
+        }
+    }
+    if (found < blocks) {
+        return PURR_NO_TERRITORY;
+    }
+
+    for (uint32_t t = first; t < first + needed; t += block_size) {
+        free_area_remove_internal(zone, t, PURR_MAX_ORDER);
+    }
+    bitmap_set_range_internal(first, needed);
+    occupied_territories += needed;
+    zone->free -= needed;
+    zone->allocations++;
+    return first;
+}
+
+uint32_t purr_alloc_territory_run(uint32_t count) {
+    if (count == 0 || count > total_territories) {
+        meow_log(MEOW_LOG_YOWL," Cannot allocate a run of %u territories", count);
+        return 0;
+    }
+
+    uint32_t first;
+    uint32_t end;
+    if (count <= (1u << PURR_MAX_ORDER)) {
+        // Take the covering power-of-two block and return the unused tail
+        uint32_t order = 0;
+        while ((1u << order) < count) {
+            order++;
+        }
+
+        uint32_t physical_address = purr_alloc_territories(order);
+        if (physical_address == 0) {
+            return 0;
+        }
+        first = physical_address / TERRITORY_SIZE;
+        end = first + (1u << order);
+    } else {
+        // Longer runs are built from adjacent max-order blocks
+        uint32_t blocks = (count + (1u << PURR_MAX_ORDER) - 1) >> PURR_MAX_ORDER;
+        purr_zone_t* zones[PURR_ZONE_COUNT];
+        uint32_t zone_count = zone_list_internal(0, zones);
+
+        first = PURR_NO_TERRITORY;
+        meow_mcs_node_t node;
+        uint32_t lock_flags = meow_mcs_lock_irqsave(&purr_lock, &node);
+        for (uint32_t i = 0; i < zone_count && first == PURR_NO_TERRITORY; i++) {
+            uint32_t mark = zones[i]->watermark_low + (i > 0 ? zones[i]->lowmem_reserve : 0);
+            first = zone_alloc_blocks_internal(zones[i], blocks, mark);
+        }
+        meow_mcs_unlock_irqrestore(&purr_lock, &node, lock_flags);
+
+        if (first == PURR_NO_TERRITORY) {
+            meow_log(MEOW_LOG_HISS," No run of %u free territories!!!!", count);
+            return 0;
+        }
+        end = first + (blocks << PURR_MAX_ORDER);
+    }
+
+    meow_mcs_node_t node;
+    uint32_t lock_flags = meow_mcs_lock_irqsave(&purr_lock, &node);
+    buddy_free_range_internal(first + count, end);
+    meow_mcs_unlock_irqrestore(&purr_lock, &node, lock_flags);
+    return first * TERRITORY_SIZE;
+}
+
+void purr_free_territory_run(uint32_t physical_address, uint32_t count) {
+    if (!pmm_initialized) {
+        meow_log(MEOW_LOG_YOWL," Cannot free: PMM not initialized");
         return;
     }
-    
-    // Mark as free
-    territory_bitmap[bitmap_index] &= ~(1 << bit_position);
-    occupied_territories--;
-    
-    meow_log(MEOW_LOG_MEOW,"Freed territory %d (physical: 0x%x)", territory, physical_address);
+
+    uint32_t first = physical_address / TERRITORY_SIZE;
+    if (physical_address == 0 || first + count > total_territories || first + count < first) {
+        meow_log(MEOW_LOG_YOWL," Territory run 0x%x (+%u) out of range", physical_address, count);
+        return;
+    }
+
+    meow_mcs_node_t node;
+    uint32_t lock_flags = meow_mcs_lock_irqsave(&purr_lock, &node);
+    for (uint32_t t = first; t < first + count; t++) {
+        if (territory_is_free_internal(t)) {
+            meow_mcs_unlock_irqrestore(&purr_lock, &node, lock_flags);
+            meow_log(MEOW_LOG_HISS," Territory %d already free", t);
+            return;
+        }
+    }
+
+    buddy_free_range_internal(first, first + count);
+    meow_mcs_unlock_irqrestore(&purr_lock, &node, lock_flags);
+    MEOW_TRACE("pmm: freed %u territories at 0x%x", count, physical_address);
 }
 
 uint8_t purr_memory_validate(void) {
@@ -205,6 +930,65 @@ uint8_t purr_memory_validate(void) {
         meow_log(MEOW_LOG_YOWL," PMM validation failed: occupied > total");
         return 0;
     }
+
+    // The bitmap is the source of truth: count its free territories
+    uint32_t bitmap_free = 0;
+    for (uint32_t t = next_free_territory_internal(0); t < total_territories;) {
+        uint32_t end = next_occupied_territory_internal(t);
+        bitmap_free += end - t;
+        t = end < total_territories ? next_free_territory_internal(end) : end;
+    }
+    if (bitmap_free != total_territories - occupied_territories) {
+        meow_log(MEOW_LOG_YOWL," PMM validation failed: bitmap has %u free, counter says %u",
+                  bitmap_free, total_territories - occupied_territories);
+        return 0;
+    }
+
+    // Every buddy block must be aligned, inside its zone, tagged with its
+    // order and free in the bitmap
+    uint32_t buddy_free = 0;
+    for (uint32_t z = 0; z < PURR_ZONE_COUNT; z++) {
+        purr_zone_t* zone = &purr_zones[z];
+        uint32_t zone_free = 0;
+
+        for (uint32_t order = 0; order < PURR_ORDER_COUNT; order++) {
+            purr_free_area_t* area = &zone->free_areas[order];
+            uint32_t blocks = 0;
+            for (uint32_t t = area->head; t != PURR_NO_TERRITORY; t = territory_links[t].next) {
+                if (++blocks > area->count || (t & ((1u << order) - 1)) != 0 ||
+                    territory_order[t] != order ||
+                    t < zone->start || t + (1u << order) > zone->end) {
+                    meow_log(MEOW_LOG_YOWL," PMM validation failed: bad %s order %u block %u",
+                              zone->name, order, t);
+                    return 0;
+                }
+                for (uint32_t i = 0; i < (1u << order); i++) {
+                    if (BITMAP_TEST(t + i)) {
+                        meow_log(MEOW_LOG_YOWL," PMM validation failed: territory %u free in "
+                                  "buddy lists but occupied in bitmap", t + i);
+                        return 0;
+                    }
+                }
+            }
+            if (blocks != area->count) {
+                meow_log(MEOW_LOG_YOWL," PMM validation failed: %s order %u count mismatch",
+                          zone->name, order);
+                return 0;
+            }
+            zone_free += blocks << order;
+        }
+        if (zone_free != zone->free || zone->free > zone->managed) {
+            meow_log(MEOW_LOG_YOWL," PMM validation failed: zone %s lists hold %u, counter %u",
+                      zone->name, zone_free, zone->free);
+            return 0;
+        }
+        buddy_free += zone_free;
+    }
+    if (buddy_free != bitmap_free) {
+        meow_log(MEOW_LOG_YOWL," PMM validation failed: buddy lists hold %u, bitmap %u",
+                  buddy_free, bitmap_free);
+        return 0;
+    }
     
     meow_log(MEOW_LOG_MEOW," PMM validation passed!!!\n");
     return 1;
@@ -216,6 +1000,52 @@ void get_purr_memory_stats(uint32_t* total, uint32_t* occupied, uint32_t* free)
     if (free) *free = pmm_initialized ? (total_territories - occupied_territories) : 0;
 }
 
+uint8_t get_purr_zone_stats(uint32_t zone_id, purr_zone_stats_t* stats) {
+    if (!pmm_initialized || zone_id >= PURR_ZONE_COUNT || !stats) {
+        return 0;
+    }
+
+    purr_zone_t* zone = &purr_zones[zone_id];
+    stats->name = zone->name;
+    stats->start_territory = zone->start;
+    stats->end_territory = zone->end;
+    stats->managed = zone->managed;
+    stats->free = zone->free;
+    stats->watermark_min = zone->watermark_min;
+    stats->watermark_low = zone->watermark_low;
+    stats->watermark_high = zone->watermark_high;
+    stats->lowmem_reserve = zone->lowmem_reserve;
+    stats->allocations = zone->allocations;
+    stats->fallbacks = zone->fallbacks;
+    stats->failures = zone->failures;
+    return 1;
+}
+
+uint8_t get_purr_pcp_stats(uint32_t cpu, purr_pcp_stats_t* stats) {
+    if (!pmm_initialized || cpu >= MEOW_PERCPU_MAX_CPUS || !stats) {
+        return 0;
+    }
+
+    const purr_pcp_t* pcp = per_cpu_ptr(&purr_pcp, cpu);
+    stats->count = pcp->count;
+    stats->hits = pcp->hits;
+    stats->refills = pcp->refills;
+    stats->drains = pcp->drains;
+    return 1;
+}
+
+uint32_t get_total_territories(void) {
+    return pmm_initialized ? total_territories : 0;
+}
+
+uint32_t get_free_territories(void) {
+    return pmm_initialized ? (total_territories - occupied_territories) : 0;
+}
+
+uint32_t get_used_territories(void) {
+    return pmm_initialized ? occupied_territories : 0;
+}
+
 uint8_t is_purr_memory_initialized(void) {
     return pmm_initialized;
 }
@@ -12,14 +12,79 @@
 
 // Constants for physical memory management
 #define TERRITORY_SIZE 4096         // 4KB territories (like cat territories)
-#define MAX_TERRITORIES 32768       // Support up to 128MB of cat territories
+#define PURR_MAX_TERRITORIES 0x100000  // 4GB of 32-bit physical space; tables are sized from RAM
+
+// Two-level bitmap: one summary bit per bitmap word, set while that word has a free territory
+#define PURR_SUMMARY_SPAN (32 * 32)  // Territories covered by one summary word (4MB)
+
+// Buddy allocator: blocks of 2^order contiguous, naturally aligned territories
+#define PURR_MAX_ORDER 10           // Largest block: 1024 territories (4MB)
+#define PURR_ORDER_COUNT (PURR_MAX_ORDER + 1)
+#define PURR_ORDER_NONE 0xFF        // Territory is not the head of a free block
+#define PURR_ORDER_PCP 0xFE         // Territory sits in a per-CPU page cache
+#define PURR_NO_TERRITORY 0xFFFFFFFF
+
+// Physical memory zones, lowest first. Each zone has its own buddy free
+// lists and watermarks; zone limits are multiples of the largest block.
+#define PURR_ZONE_DMA 0             // Below 16MB, reachable by ISA DMA
+#define PURR_ZONE_NORMAL 1          // Up to the end of the kernel direct map
+#define PURR_ZONE_HIGH 2            // Above the direct map, mapped by the caller
+#define PURR_ZONE_COUNT 3
+#define PURR_ZONE_DMA_LIMIT 0x01000000      // 16MB
+#define PURR_ZONE_NORMAL_LIMIT 0x38000000   // 896MB direct map
+
+// Watermarks, in territories: min is managed / PURR_WATERMARK_RATIO within
+// [PURR_WATERMARK_FLOOR, PURR_WATERMARK_CEILING], low is min * 5/4 and high
+// is min * 3/2. A lower zone keeps managed memory of the zones above it /
+// PURR_LOWMEM_RESERVE_RATIO back from allocations that fall into it.
+#define PURR_WATERMARK_RATIO 128
+#define PURR_WATERMARK_FLOOR 8
+#define PURR_WATERMARK_CEILING 1024
+#define PURR_LOWMEM_RESERVE_RATIO 32
+
+// Allocation flags for purr_alloc_territories_flags()
+#define PURR_ALLOC_DMA 0x1          // Only ZONE_DMA will do
+#define PURR_ALLOC_HIGH 0x2         // ZONE_HIGH is fine, the caller maps it
+#define PURR_ALLOC_COLD 0x4         // Prefer a cache-cold territory (device writes it first)
+
+// Per-CPU page caches: single territories from the default zones are
+// served from, and freed to, a list private to each CPU. An empty list
+// refills PURR_PCP_BATCH territories from the zones in one go; a list
+// above PURR_PCP_HIGH drains its coldest PURR_PCP_BATCH back.
+#define PURR_PCP_BATCH 16
+#define PURR_PCP_HIGH 64
+
+// Snapshot of one CPU's page cache
+typedef struct purr_pcp_stats {
+    uint32_t count;                 // Territories cached now
+    uint32_t hits;                  // Allocations served from the cache
+    uint32_t refills;               // Batches taken from the zones
+    uint32_t drains;                // Batches given back to the zones
+} purr_pcp_stats_t;
+
+// Snapshot of one zone
+typedef struct purr_zone_stats {
+    const char* name;
+    uint32_t start_territory;       // First territory of the zone
+    uint32_t end_territory;         // One past the last territory of the zone
+    uint32_t managed;               // RAM territories the zone hands out
+    uint32_t free;                  // Territories on the zone's free lists
+    uint32_t watermark_min;
+    uint32_t watermark_low;
+    uint32_t watermark_high;
+    uint32_t lowmem_reserve;        // Held back from higher zone fallbacks
+    uint32_t allocations;           // Blocks handed out
+    uint32_t fallbacks;             // ...of which for a higher zone's request
+    uint32_t failures;              // Requests this zone could not serve
+} purr_zone_stats_t;
 
 // =============================================================================
 // FUNCTION DECLARATIONS
 // =============================================================================
 
-// Initialize the Purr Memory Manager
-void purr_memory_init(uint32_t memory_size);
+// Initialize the Purr Memory Manager. memory_size is the end of the highest
+// available range; the zones are seeded from the territory map below it.
+void purr_memory_init(uint64_t memory_size);
 
 // Allocate a territory (like a cat claiming a spot)
 uint32_t purr_alloc_territory(void);
@@ -27,6 +92,23 @@ uint32_t purr_alloc_territory(void);
 // Free a territory (cat abandons a spot)  
 void purr_free_territory(uint32_t);
 
+// Allocate/free 2^order contiguous territories aligned to their size.
+// purr_alloc_territories() serves ZONE_NORMAL first and falls back to
+// ZONE_DMA; pass PURR_ALLOC_* flags to pick the zones explicitly.
+uint32_t purr_alloc_territories(uint32_t order);
+uint32_t purr_alloc_territories_flags(uint32_t order, uint32_t flags);
+void purr_free_territories(uint32_t physical_address, uint32_t order);
+
+// Free a territory the CPU has not touched lately; it is reused last
+void purr_free_territory_cold(uint32_t physical_address);
+
+// Give this CPU's cached territories back to the zones
+void purr_drain_cpu_cache(void);
+
+// Allocate/free a physically contiguous run of territories (a cat colony)
+uint32_t purr_alloc_territory_run(uint32_t count);
+void purr_free_territory_run(uint32_t physical_address, uint32_t count);
+
 // Display purr status (how content our memory manager is)
 void purr_status(void);
 
@@ -40,10 +122,14 @@ void purr_debug_info(void);
 void print_territory_bitmap(void);
 
 // Memory validation functions
+uint8_t purr_memory_validate(void);
 uint8_t is_valid_territory(void* territory);
 uint8_t is_territory_free(void* territory);
 
 void get_purr_memory_stats(uint32_t* total, uint32_t* occupied, uint32_t* free);
+uint8_t get_purr_zone_stats(uint32_t zone, purr_zone_stats_t* stats);
+uint8_t get_purr_pcp_stats(uint32_t cpu, purr_pcp_stats_t* stats);
+uint8_t is_purr_memory_initialized(void);
 
 #endif // MEOW_PHYSICAL_MEMORY_H
 
@@ -0,0 +1,340 @@
+/* advanced/mm/meow_slab_allocator.c - MeowKernel Slab Object Cache Implementation
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "meow_slab_allocator.h"
+#include "meow_physical_memory.h"
+#include "../../kernel/meow_util.h"
+
+/* ============================================================================
+ * CAT CACHE GLOBAL STATE
+ * ============================================================================ */
+
+static meow_cache_t cat_caches[MEOW_CACHE_MAX_CACHES];
+
+MEOW_LOCK_CLASS(cache_table_lock_class, "cat-cache-table");
+MEOW_LOCK_CLASS(cache_lock_class, "cat-cache");
+static meow_spinlock_t cache_table_lock = MEOW_SPINLOCK_INIT(&cache_table_lock_class);
+
+#define SLAB_OF(obj) \
+    ((cat_slab_t*)((uintptr_t)(obj) & ~(uintptr_t)(TERRITORY_SIZE - 1)))
+
+/* ============================================================================
+ * INTERNAL HELPER FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * slab_list_push_internal - Put a slab at the head of a cache list
+ */
+static inline void slab_list_push_internal(cat_slab_t** list, cat_slab_t* slab) {
+    slab->prev = NULL;
+    slab->next = *list;
+    if (*list) {
+        (*list)->prev = slab;
+    }
+    *list = slab;
+}
+
+/**
+ * slab_list_remove_internal - Unlink a slab from a cache list
+ */
+static inline void slab_list_remove_internal(cat_slab_t** list, cat_slab_t* slab) {
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        *list = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+}
+
+/**
+ * slab_grow_internal - Carve a fresh territory into objects
+ */
+static cat_slab_t* slab_grow_internal(meow_cache_t* cache) {
+    uint32_t territory = purr_alloc_territory();
+    if (!territory) {
+        return NULL;
+    }
+
+    cat_slab_t* slab = (cat_slab_t*)territory;
+    slab->cache = cache;
+    slab->in_use = 0;
+    slab->magic = MEOW_CACHE_SLAB_MAGIC;
+
+    /* Thread the free list front to back so early objects are used first */
+    uint8_t* obj = (uint8_t*)slab + cache->first_offset;
+    slab->free_objects = obj;
+    for (uint32_t i = 1; i < cache->objects_per_slab; i++) {
+        *(void**)obj = obj + cache->stride;
+        obj += cache->stride;
+    }
+    *(void**)obj = NULL;
+
+    cache->slab_count++;
+    slab_list_push_internal(&cache->partial_slabs, slab);
+    return slab;
+}
+
+/**
+ * slab_release_internal - Give a slab's territory back to the PMM
+ */
+static void slab_release_internal(meow_cache_t* cache, cat_slab_t* slab) {
+    slab->magic = 0;
+    cache->slab_count--;
+    purr_free_territory((uint32_t)(uintptr_t)slab);
+}
+
+/* ============================================================================
+ * CAT CACHE CORE FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * meow_cache_create - Create an object cache
+ */
+meow_cache_t* meow_cache_create(const char* name, size_t obj_size, size_t align,
+                                meow_cache_ctor_t ctor) {
+    if (!name || obj_size == 0) {
+        meow_log(MEOW_LOG_YOWL, "Invalid cat cache parameters");
+        return NULL;
+    }
+
+    if (align == 0) {
+        align = MEOW_CACHE_MIN_ALIGN;
+    }
+    if ((align & (align - 1)) != 0 || align >= TERRITORY_SIZE) {
+        meow_log(MEOW_LOG_YOWL, "Cat cache '%s': bad alignment %u", name, (uint32_t)align);
+        return NULL;
+    }
+    if (align < MEOW_CACHE_MIN_ALIGN) {
+        align = MEOW_CACHE_MIN_ALIGN;
+    }
+
+    /* Free objects must be able to hold the free list link */
+    uint32_t stride = obj_size < sizeof(void*) ? sizeof(void*) : (uint32_t)obj_size;
+    stride = MEOW_ALIGN_UP(stride, align);
+    uint32_t first_offset = MEOW_ALIGN_UP(sizeof(cat_slab_t), align);
+    if (first_offset + stride > TERRITORY_SIZE) {
+        meow_log(MEOW_LOG_YOWL, "Cat cache '%s': %u byte objects do not fit a territory",
+                 name, (uint32_t)obj_size);
+        return NULL;
+    }
+
+    meow_cache_t* cache = NULL;
+    uint32_t flags = meow_spin_lock_irqsave(&cache_table_lock);
+    for (uint32_t i = 0; i < MEOW_CACHE_MAX_CACHES; i++) {
+        if (!cat_caches[i].in_use) {
+            cache = &cat_caches[i];
+            break;
+        }
+    }
+    if (!cache) {
+        meow_spin_unlock_irqrestore(&cache_table_lock, flags);
+        meow_log(MEOW_LOG_YOWL, "Cat cache table full, cannot create '%s'", name);
+        return NULL;
+    }
+
+    meow_memset(cache, 0, sizeof(*cache));
+    meow_strcpy(cache->name, name, sizeof(cache->name));
+    cache->object_size = (uint32_t)obj_size;
+    cache->stride = stride;
+    cache->first_offset = first_offset;
+    cache->objects_per_slab = (TERRITORY_SIZE - first_offset) / stride;
+    cache->ctor = ctor;
+    meow_spin_init(&cache->lock, &cache_lock_class);
+    cache->in_use = 1;
+    meow_spin_unlock_irqrestore(&cache_table_lock, flags);
+
+    meow_log(MEOW_LOG_CHIRP, "Cat cache '%s' created: %u byte objects, %u per territory",
+             cache->name, stride, cache->objects_per_slab);
+    return cache;
+}
+
+/**
+ * meow_cache_destroy - Destroy an object cache
+ */
+meow_error_t meow_cache_destroy(meow_cache_t* cache) {
+    MEOW_RETURN_IF_NULL(cache);
+    if (!cache->in_use) {
+        return MEOW_ERROR_INVALID_HANDLE;
+    }
+    uint32_t flags = meow_spin_lock_irqsave(&cache->lock);
+    if (cache->active_objects > 0) {
+        meow_spin_unlock_irqrestore(&cache->lock, flags);
+        meow_log(MEOW_LOG_HISS, "Cat cache '%s' still has %u objects out",
+                 cache->name, cache->active_objects);
+        return MEOW_ERROR_INVALID_STATE;
+    }
+
+    /* With no active objects every slab sits on the empty list */
+    while (cache->empty_slabs) {
+        cat_slab_t* slab = cache->empty_slabs;
+        slab_list_remove_internal(&cache->empty_slabs, slab);
+        slab_release_internal(cache, slab);
+    }
+    while (cache->partial_slabs) {
+        cat_slab_t* slab = cache->partial_slabs;
+        slab_list_remove_internal(&cache->partial_slabs, slab);
+        slab_release_internal(cache, slab);
+    }
+
+    cache->in_use = 0;
+    meow_spin_unlock_irqrestore(&cache->lock, flags);
+    return MEOW_SUCCESS;
+}
+
+/**
+ * meow_cache_alloc - Allocate one object from a cache
+ */
+void* meow_cache_alloc(meow_cache_t* cache) {
+    if (!cache || !cache->in_use) {
+        return NULL;
+    }
+
+    uint32_t flags = meow_spin_lock_irqsave(&cache->lock);
+    cat_slab_t* slab = cache->partial_slabs;
+    if (!slab) {
+        slab = cache->empty_slabs;
+        if (slab) {
+            slab_list_remove_internal(&cache->empty_slabs, slab);
+            slab_list_push_internal(&cache->partial_slabs, slab);
+        } else {
+            slab = slab_grow_internal(cache);
+            if (!slab) {
+                cache->failures++;
+                meow_spin_unlock_irqrestore(&cache->lock, flags);
+                meow_log(MEOW_LOG_HISS, "Cat cache '%s' could not get a territory", cache->name);
+                return NULL;
+            }
+        }
+    }
+
+    void* obj = slab->free_objects;
+    slab->free_objects = *(void**)obj;
+    slab->in_use++;
+    if (!slab->free_objects) {
+        slab_list_remove_internal(&cache->partial_slabs, slab);
+        slab_list_push_internal(&cache->full_slabs, slab);
+    }
+
+    cache->active_objects++;
+    cache->allocations++;
+    meow_spin_unlock_irqrestore(&cache->lock, flags);
+
+    if (cache->ctor) {
+        cache->ctor(obj);
+    }
+    return obj;
+}
+
+/**
+ * meow_cache_free - Return an object to its cache
+ */
+meow_error_t meow_cache_free(meow_cache_t* cache, void* obj) {
+    if (!obj) {
+        return MEOW_SUCCESS;
+    }
+    MEOW_RETURN_IF_NULL(cache);
+
+    cat_slab_t* slab = SLAB_OF(obj);
+    uint32_t offset = (uint32_t)((uintptr_t)obj - (uintptr_t)slab);
+    if (slab->magic != MEOW_CACHE_SLAB_MAGIC || slab->cache != cache ||
+        offset < cache->first_offset ||
+        (offset - cache->first_offset) % cache->stride != 0 ||
+        slab->in_use == 0) {
+        meow_log(MEOW_LOG_YOWL, "Object 0x%08x does not belong to cat cache '%s'",
+                 (uint32_t)(uintptr_t)obj, cache->name);
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    uint32_t flags = meow_spin_lock_irqsave(&cache->lock);
+    uint8_t was_full = (slab->free_objects == NULL);
+    *(void**)obj = slab->free_objects;
+    slab->free_objects = obj;
+    slab->in_use--;
+
+    cache->active_objects--;
+    cache->deallocations++;
+
+    if (slab->in_use == 0) {
+        slab_list_remove_internal(was_full ? &cache->full_slabs : &cache->partial_slabs, slab);
+        if (cache->empty_slabs) {
+            /* Keep one empty slab warm, hand any other back to the PMM */
+            slab_release_internal(cache, slab);
+        } else {
+            slab_list_push_internal(&cache->empty_slabs, slab);
+        }
+    } else if (was_full) {
+        slab_list_remove_internal(&cache->full_slabs, slab);
+        slab_list_push_internal(&cache->partial_slabs, slab);
+    }
+    meow_spin_unlock_irqrestore(&cache->lock, flags);
+
+    return MEOW_SUCCESS;
+}
+
+/* ============================================================================
+ * CAT CACHE STATISTICS
+ * ============================================================================ */
+
+/**
+ * meow_cache_get_stats - Get utilisation statistics of one cache
+ */
+meow_error_t meow_cache_get_stats(const meow_cache_t* cache, meow_cache_stats_t* stats) {
+    MEOW_RETURN_IF_NULL(cache);
+    MEOW_RETURN_IF_NULL(stats);
+    if (!cache->in_use) {
+        return MEOW_ERROR_INVALID_HANDLE;
+    }
+
+    stats->name = cache->name;
+    stats->object_size = cache->object_size;
+    stats->stride = cache->stride;
+    stats->objects_per_slab = cache->objects_per_slab;
+    stats->slab_count = cache->slab_count;
+    stats->active_objects = cache->active_objects;
+    stats->total_objects = cache->slab_count * cache->objects_per_slab;
+    stats->allocations = cache->allocations;
+    stats->deallocations = cache->deallocations;
+    stats->failures = cache->failures;
+    stats->utilization = stats->total_objects > 0 ?
+        (stats->active_objects * 100) / stats->total_objects : 0;
+    return MEOW_SUCCESS;
+}
+
+/**
+ * meow_cache_get_totals - Sum up all caches
+ */
+uint32_t meow_cache_get_totals(uint32_t* slab_territories, uint32_t* active_objects) {
+    uint32_t caches = 0, territories = 0, objects = 0;
+
+    for (uint32_t i = 0; i < MEOW_CACHE_MAX_CACHES; i++) {
+        if (cat_caches[i].in_use) {
+            caches++;
+            territories += cat_caches[i].slab_count;
+            objects += cat_caches[i].active_objects;
+        }
+    }
+
+    if (slab_territories) *slab_territories = territories;
+    if (active_objects) *active_objects = objects;
+    return caches;
+}
+
+/**
+ * meow_cache_print_stats - Print one utilisation line per cache
+ */
+void meow_cache_print_stats(void) {
+    meow_printf("---- cat caches (size: active / total objects, slabs, util) ----\n");
+    for (uint32_t i = 0; i < MEOW_CACHE_MAX_CACHES; i++) {
+        meow_cache_stats_t stats;
+        if (meow_cache_get_stats(&cat_caches[i], &stats) != MEOW_SUCCESS) {
+            continue;
+        }
+        meow_printf("  %s %u: %u / %u, %u slabs, %u%%\n", stats.name, stats.object_size,
+                    stats.active_objects, stats.total_objects, stats.slab_count,
+                    stats.utilization);
+    }
+}
@@ -0,0 +1,171 @@
+/* advanced/mm/meow_slab_allocator.h - MeowKernel Slab Object Cache Interface
+ *
+ * MeowKernel Memory Management - Fixed-size object caches carved from
+ * physical territories
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#ifndef MEOW_SLAB_ALLOCATOR_H
+#define MEOW_SLAB_ALLOCATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../hal/meow_hal_interface.h"
+#include "../../kernel/meow_lock.h"
+
+/* ============================================================================
+ * CAT CACHE CONSTANTS AND CONFIGURATION
+ * ============================================================================ */
+
+#define MEOW_CACHE_MAX_CACHES       32          /* Caches live in a static table */
+#define MEOW_CACHE_NAME_LENGTH      24          /* Including terminating NUL */
+#define MEOW_CACHE_MIN_ALIGN        4           /* Free list link alignment */
+#define MEOW_CACHE_SLAB_MAGIC       0x51AB      /* Marks a territory as a slab */
+
+/* ============================================================================
+ * CAT CACHE DATA STRUCTURES
+ * ============================================================================ */
+
+/**
+ * meow_cache_ctor_t - Object constructor
+ *
+ * Called on every object handed out by meow_cache_alloc. Free objects hold
+ * the cache's free list link in their first word, so constructed state is
+ * not preserved across a free.
+ */
+typedef void (*meow_cache_ctor_t)(void* obj);
+
+/**
+ * cat_slab - One territory carved into equally sized objects
+ *
+ * The descriptor sits at the start of its own territory, so the slab of any
+ * object is found by rounding its address down to TERRITORY_SIZE. Objects
+ * carry no header; free ones are chained through their first word.
+ */
+typedef struct cat_slab {
+    struct cat_slab* next;              /* Next slab on the same cache list */
+    struct cat_slab* prev;              /* Previous slab on the same cache list */
+    struct meow_cache* cache;           /* Owning cache */
+    void* free_objects;                 /* Embedded free list of objects */
+    uint16_t in_use;                    /* Objects currently handed out */
+    uint16_t magic;                     /* MEOW_CACHE_SLAB_MAGIC */
+} cat_slab_t;
+
+/**
+ * meow_cache - Object cache for one object size
+ *
+ * Slabs move between the partial, full and empty lists as objects come and
+ * go. At most one empty slab is kept around; further empty slabs go back to
+ * the physical memory manager.
+ */
+typedef struct meow_cache {
+    char name[MEOW_CACHE_NAME_LENGTH];  /* Human readable cache name */
+    uint32_t object_size;               /* Requested object size */
+    uint32_t stride;                    /* Aligned distance between objects */
+    uint32_t first_offset;              /* Offset of object 0 in a slab */
+    uint32_t objects_per_slab;          /* Objects carved from one territory */
+    meow_cache_ctor_t ctor;             /* Optional constructor */
+    cat_slab_t* partial_slabs;          /* Slabs with some free objects */
+    cat_slab_t* full_slabs;             /* Slabs with no free objects */
+    cat_slab_t* empty_slabs;            /* Slabs with every object free */
+    uint32_t slab_count;                /* Territories owned by this cache */
+    uint32_t active_objects;            /* Objects currently allocated */
+    uint32_t allocations;               /* Total allocation count */
+    uint32_t deallocations;             /* Total deallocation count */
+    uint32_t failures;                  /* Allocation failure count */
+    uint8_t in_use;                     /* Table slot is taken */
+    meow_spinlock_t lock;               /* Guards the slab lists and counters */
+} meow_cache_t;
+
+/**
+ * meow_cache_stats - Utilisation snapshot of one cache
+ */
+typedef struct meow_cache_stats {
+    const char* name;           /* Cache name */
+    uint32_t object_size;       /* Requested object size */
+    uint32_t stride;            /* Bytes consumed per object */
+    uint32_t objects_per_slab;  /* Objects per territory */
+    uint32_t slab_count;        /* Territories owned */
+    uint32_t active_objects;    /* Objects allocated */
+    uint32_t total_objects;     /* Objects the owned slabs can hold */
+    uint32_t allocations;       /* Total allocation count */
+    uint32_t deallocations;     /* Total deallocation count */
+    uint32_t failures;          /* Allocation failure count */
+    uint32_t utilization;       /* active_objects as a percentage of total_objects */
+} meow_cache_stats_t;
+
+/* ============================================================================
+ * CAT CACHE CORE FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * meow_cache_create - Create an object cache
+ * @name: Cache name (copied, truncated to MEOW_CACHE_NAME_LENGTH - 1)
+ * @obj_size: Size of each object in bytes
+ * @align: Object alignment, a power of two (0 for the default)
+ * @ctor: Optional constructor run on every allocation (may be NULL)
+ *
+ * @return New cache, or NULL if the arguments are invalid, the object does
+ *         not fit in a territory or the cache table is full
+ */
+meow_cache_t* meow_cache_create(const char* name, size_t obj_size, size_t align,
+                                meow_cache_ctor_t ctor);
+
+/**
+ * meow_cache_destroy - Destroy an object cache
+ * @cache: Cache to destroy
+ *
+ * Returns every slab to the physical memory manager. Fails with
+ * MEOW_ERROR_INVALID_STATE while objects are still allocated.
+ *
+ * @return MEOW_SUCCESS on success, error code on failure
+ */
+meow_error_t meow_cache_destroy(meow_cache_t* cache);
+
+/**
+ * meow_cache_alloc - Allocate one object from a cache
+ * @cache: Cache to allocate from
+ *
+ * @return Pointer to the object, or NULL if no territory could be obtained
+ */
+void* meow_cache_alloc(meow_cache_t* cache);
+
+/**
+ * meow_cache_free - Return an object to its cache
+ * @cache: Cache the object was allocated from
+ * @obj: Object to free (NULL is ignored)
+ *
+ * @return MEOW_SUCCESS on success, error code if the object does not belong
+ *         to the cache
+ */
+meow_error_t meow_cache_free(meow_cache_t* cache, void* obj);
+
+/* ============================================================================
+ * CAT CACHE STATISTICS
+ * ============================================================================ */
+
+/**
+ * meow_cache_get_stats - Get utilisation statistics of one cache
+ * @cache: Cache to inspect
+ * @stats: Structure to fill
+ *
+ * @return MEOW_SUCCESS on success, error code on failure
+ */
+meow_error_t meow_cache_get_stats(const meow_cache_t* cache, meow_cache_stats_t* stats);
+
+/**
+ * meow_cache_get_totals - Sum up all caches
+ * @slab_territories: Territories owned by all caches (may be NULL)
+ * @active_objects: Objects allocated from all caches (may be NULL)
+ *
+ * @return Number of live caches
+ */
+uint32_t meow_cache_get_totals(uint32_t* slab_territories, uint32_t* active_objects);
+
+/**
+ * meow_cache_print_stats - Print one utilisation line per cache
+ */
+void meow_cache_print_stats(void);
+
+#endif /* MEOW_SLAB_ALLOCATOR_H */
@@ -18,10 +18,17 @@ ARCH_HAL_SOURCES = advanced/hal/x86/x86_meow_hal.c \
                    advanced/hal/x86/x86_interrupt_tables.c \
                    advanced/hal/x86/x86_interrupt_controller.c \
                    advanced/hal/x86/x86_system_timer.c \
-				   advanced/hal/x86/x86_platform_support.c
+				   advanced/hal/x86/x86_platform_support.c \
+				   advanced/hal/x86/x86_paging.c \
+				   advanced/hal/x86/x86_acpi.c \
+				   advanced/hal/x86/x86_apic.c \
+				   advanced/hal/x86/x86_smp.c \
+				   advanced/hal/x86/x86_serial.c
 ASM_SOURCES = advanced/hal/x86/x86_gdt_flush.S \
               advanced/hal/x86/x86_interrupt_handlers.S \
-			  advanced/hal/x86/x86_assembly_functions.S
+			  advanced/hal/x86/x86_assembly_functions.S \
+			  advanced/hal/x86/x86_context_switch.S \
+			  advanced/hal/x86/x86_smp_trampoline.S
 
 # Object files
 BOOT_OBJECTS = $(BOOT_SOURCES:%.S=$(OBJDIR)/%.o)
@@ -32,7 +39,10 @@ LINKER_SCRIPT = scripts/x86/linker.ld
 
 # QEMU configuration
 QEMU = qemu-system-i386
-QEMU_FLAGS = -m 512M
+QEMU_SMP ?= 2
+# COM1 is the full kernel log
+SERIAL_LOG ?= $(BUILDDIR)/serial.log
+QEMU_FLAGS = -m 512M -smp $(QEMU_SMP) -serial file:$(SERIAL_LOG)
 
 # x86-specific targets
 KERNEL_ISO = $(BUILDDIR)/meowkernel-x86.iso
@@ -1,11 +1,12 @@
 # Common build rules for all architectures
 
 # Common source files
-KERNEL_SOURCES = kernel/meow_kernel_main.c kernel/meow_util.c lib/runtime.c
+KERNEL_SOURCES = kernel/meow_kernel_main.c kernel/meow_util.c kernel/meow_tick.c kernel/meow_timer.c kernel/meow_thread.c kernel/meow_lock.c kernel/meow_percpu.c kernel/meow_dmesg.c kernel/meow_trace.c lib/runtime.c
 HAL_SOURCES = advanced/hal/meow_hal_manager.c
 MEM_SOURCES = advanced/mm/meow_memory_manager.c \
 	    advanced/mm/meow_memory_mapper.c \
         advanced/mm/meow_heap_allocator.c \
+        advanced/mm/meow_slab_allocator.c \
 	    advanced/mm/meow_physical_memory.c
 
 KERNEL_OBJECTS = $(KERNEL_SOURCES:%.c=$(OBJDIR)/%.o)
@@ -23,6 +24,16 @@ ALL_OBJECTS = $(BOOT_OBJECTS) \
 CFLAGS_COMMON = -std=gnu99 -ffreestanding -O2 -Wall -Wextra
 CFLAGS_COMMON += -nostdlib -fno-builtin -fno-stack-protector -fno-pic -fno-pie
 
+# Build options: LOCK_STATS=1 records per lock class contention statistics
+LOCK_STATS ?= 0
+CFLAGS_COMMON += -DMEOW_LOCK_STATS=$(LOCK_STATS)
+# TRACE=0 compiles out the MEOW_TRACE binary trace events
+TRACE ?= 1
+CFLAGS_COMMON += -DMEOW_TRACING=$(TRACE)
+# LOG_LEVEL=MEOW|CHIRP|... compiles out meow_log() calls below that level
+LOG_LEVEL ?= PURR
+CFLAGS_COMMON += -DMEOW_LOG_MIN_LEVEL=MEOW_LOG_$(LOG_LEVEL)
+
 # Include directories
 INCLUDES = -Ikernel -Iadvanced/hal -Iadvanced
 
@@ -0,0 +1,243 @@
+/* kernel/meow_dmesg.c - MeowKernel Kernel Log Ring
+ *
+ * Slot states: (seq << 1) | 1 while record seq is being written, then
+ * seq << 1 once it is complete. A reader checks the state before and
+ * after copying a slot and drops the copy if it changed.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "meow_dmesg.h"
+#include "meow_util.h"
+#include "meow_lock.h"
+#include "meow_tick.h"
+#include "meow_thread.h"
+#include "meow_timer.h"
+#include "../advanced/hal/meow_hal_interface.h"
+
+#define DMESG_RECORD_MASK   (MEOW_DMESG_RECORDS - 1)
+
+typedef struct dmesg_slot {
+    volatile uint32_t state;
+    meow_dmesg_record_t record;
+} dmesg_slot_t;
+
+typedef struct dmesg_ring {
+    volatile uint32_t head;             /* Next sequence number to write */
+    dmesg_slot_t slots[MEOW_DMESG_RECORDS];
+} dmesg_ring_t;
+
+static MEOW_DEFINE_PER_CPU(dmesg_ring_t, dmesg_ring);
+
+/* Console drawing state; the iterator is only touched under drain_lock */
+MEOW_LOCK_CLASS(dmesg_drain_lock_class, "dmesg-drain");
+static meow_spinlock_t drain_lock = MEOW_SPINLOCK_INIT(&dmesg_drain_lock_class);
+static meow_dmesg_iter_t drain_iter;
+static uint32_t drain_lost_reported = 0;
+static volatile uint8_t dmesg_deferred = 0;
+
+/* ============================================================================
+ * RING HELPERS
+ * ============================================================================ */
+
+static uint32_t dmesg_cpu_count_internal(void) {
+    uint32_t cpus = HAL_CPU_OP_SAFE(get_cpu_count, 1);
+    return cpus < MEOW_PERCPU_MAX_CPUS ? cpus : MEOW_PERCPU_MAX_CPUS;
+}
+
+/*
+ * Find the next intact record of @cpu at or after iter->next[cpu] without
+ * consuming it. Copies it to @record when non-NULL, else only reports its
+ * timestamp. Skipped records are counted as lost.
+ */
+static uint8_t dmesg_peek_internal(meow_dmesg_iter_t* iter, uint32_t cpu,
+                                   meow_dmesg_record_t* record, uint64_t* timestamp_ns) {
+    dmesg_ring_t* ring = per_cpu_ptr(&dmesg_ring, cpu);
+
+    for (;;) {
+        uint32_t seq = iter->next[cpu];
+        uint32_t head = meow_load_acquire_u32(&ring->head);
+        if (seq == head) {
+            return 0;
+        }
+        if (head - seq > MEOW_DMESG_RECORDS) {
+            iter->lost += head - MEOW_DMESG_RECORDS - seq;
+            iter->next[cpu] = head - MEOW_DMESG_RECORDS;
+            continue;
+        }
+
+        dmesg_slot_t* slot = &ring->slots[seq & DMESG_RECORD_MASK];
+        uint32_t state = meow_load_acquire_u32(&slot->state);
+        if (state == seq << 1) {
+            if (record) {
+                meow_memcpy(record, &slot->record, sizeof(*record));
+            } else {
+                *timestamp_ns = slot->record.timestamp_ns;
+            }
+            meow_rmb();
+            if (slot->state == state) {
+                if (record) {
+                    *timestamp_ns = record->timestamp_ns;
+                }
+                return 1;
+            }
+        }
+
+        /* Overwritten under us */
+        iter->lost++;
+        iter->next[cpu] = seq + 1;
+    }
+}
+
+static uint8_t dmesg_pending_internal(void) {
+    uint32_t cpus = dmesg_cpu_count_internal();
+
+    for (uint32_t cpu = 0; cpu < cpus; cpu++) {
+        dmesg_ring_t* ring = per_cpu_ptr(&dmesg_ring, cpu);
+        if (meow_load_acquire_u32(&ring->head) != drain_iter.next[cpu]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * DMESG INTERFACE
+ * ============================================================================ */
+
+void meow_dmesg_log(uint8_t level, const char* text, uint32_t length) {
+    if (length > MEOW_DMESG_TEXT_SIZE - 1) {
+        length = MEOW_DMESG_TEXT_SIZE - 1;
+    }
+
+    /* The interrupted context may be halfway through this CPU's ring */
+    uint32_t flags = meow_irq_save();
+    dmesg_ring_t* ring = this_cpu_ptr(&dmesg_ring);
+    uint32_t seq = ring->head;
+    dmesg_slot_t* slot = &ring->slots[seq & DMESG_RECORD_MASK];
+
+    slot->state = (seq << 1) | 1;
+    meow_wmb();
+    slot->record.timestamp_ns = meow_tick_now_ns();
+    slot->record.seq = seq;
+    slot->record.level = level;
+    slot->record.cpu = (uint8_t)meow_this_cpu();
+    slot->record.length = (uint16_t)length;
+    meow_memcpy(slot->record.text, text, length);
+    slot->record.text[length] = '\0';
+    meow_store_release_u32(&slot->state, seq << 1);
+    meow_store_release_u32(&ring->head, seq + 1);
+    meow_irq_restore(flags);
+
+    if (!dmesg_deferred || level >= MEOW_LOG_SCREECH) {
+        meow_dmesg_flush();
+    }
+}
+
+void meow_dmesg_flush(void) {
+    meow_dmesg_record_t record;
+
+    do {
+        if (!meow_spin_trylock(&drain_lock)) {
+            return;
+        }
+        while (meow_dmesg_read(&drain_iter, &record)) {
+            if (drain_iter.lost != drain_lost_reported) {
+                char note[48];
+                meow_strcpy(note, "dmesg: ", sizeof(note));
+                meow_uint_to_string(drain_iter.lost - drain_lost_reported,
+                                    note + meow_strlen(note), 10);
+                meow_strcat(note, " messages lost");
+                drain_lost_reported = drain_iter.lost;
+                meow_log_render(MEOW_LOG_HISS, note);
+            }
+            meow_log_render((meow_log_level_t)record.level, record.text);
+        }
+        meow_spin_unlock(&drain_lock);
+        /* Someone may have given up on the lock while we were drawing */
+    } while (dmesg_pending_internal());
+}
+
+static void dmesg_drain_thread_internal(void* arg) {
+    (void)arg;
+
+    for (;;) {
+        meow_dmesg_flush();
+        if (meow_sleep(MEOW_DMESG_DRAIN_MS) != MEOW_SUCCESS) {
+            /* No timers: go back to drawing in the caller */
+            dmesg_deferred = 0;
+            meow_dmesg_flush();
+            meow_thread_exit();
+        }
+    }
+}
+
+meow_error_t meow_dmesg_start_drain(void) {
+    if (dmesg_deferred) {
+        return MEOW_ERROR_ALREADY_INITIALIZED;
+    }
+
+    meow_thread_t* thread = meow_thread_create("kitten-dmesg", dmesg_drain_thread_internal, NULL);
+    if (!thread) {
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+    meow_thread_set_priority(thread, MEOW_THREAD_PRIORITY_LOW);
+    dmesg_deferred = 1;
+    return MEOW_SUCCESS;
+}
+
+void meow_dmesg_iter_init(meow_dmesg_iter_t* iter) {
+    meow_memset(iter, 0, sizeof(*iter));
+
+    uint32_t cpus = dmesg_cpu_count_internal();
+    for (uint32_t cpu = 0; cpu < cpus; cpu++) {
+        uint32_t head = meow_load_acquire_u32(&per_cpu_ptr(&dmesg_ring, cpu)->head);
+        iter->next[cpu] = head > MEOW_DMESG_RECORDS ? head - MEOW_DMESG_RECORDS : 0;
+    }
+}
+
+uint8_t meow_dmesg_read(meow_dmesg_iter_t* iter, meow_dmesg_record_t* record) {
+    uint32_t cpus = dmesg_cpu_count_internal();
+
+    for (;;) {
+        /* Oldest head record across the CPUs */
+        uint32_t best_cpu = MEOW_PERCPU_MAX_CPUS;
+        uint64_t best_ns = 0;
+        for (uint32_t cpu = 0; cpu < cpus; cpu++) {
+            uint64_t timestamp_ns;
+            if (dmesg_peek_internal(iter, cpu, NULL, &timestamp_ns) &&
+                (best_cpu == MEOW_PERCPU_MAX_CPUS || timestamp_ns < best_ns)) {
+                best_cpu = cpu;
+                best_ns = timestamp_ns;
+            }
+        }
+        if (best_cpu == MEOW_PERCPU_MAX_CPUS) {
+            return 0;
+        }
+
+        /* It may be overwritten by now; then look again */
+        uint32_t seq = iter->next[best_cpu];
+        uint64_t timestamp_ns;
+        if (dmesg_peek_internal(iter, best_cpu, record, &timestamp_ns) &&
+            iter->next[best_cpu] == seq) {
+            iter->next[best_cpu] = seq + 1;
+            return 1;
+        }
+    }
+}
+
+void meow_dmesg(void) {
+    meow_dmesg_iter_t iter;
+    meow_dmesg_record_t record;
+
+    meow_dmesg_iter_init(&iter);
+    while (meow_dmesg_read(&iter, &record)) {
+        uint32_t seconds = (uint32_t)(record.timestamp_ns / 1000000000ULL);
+        uint32_t micros = (uint32_t)(record.timestamp_ns - seconds * 1000000000ULL) / 1000;
+        meow_printf("[%5u.%06u] cpu%u <%u> %s\n", seconds, micros, record.cpu,
+                    record.level, record.text);
+    }
+    if (iter.lost) {
+        meow_printf("(%u messages overwritten while reading)\n", iter.lost);
+    }
+}
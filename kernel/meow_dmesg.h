@@ -0,0 +1,105 @@
+/* kernel/meow_dmesg.h - MeowKernel Kernel Log Ring
+ *
+ * meow_log() only stores a record (timestamp, level, CPU, text) in a
+ * ring owned by the logging CPU; nothing waits for the console. A low
+ * priority kitten later draws the records on the consoles in timestamp
+ * order. Until that kitten runs, and for SCREECH messages, the caller
+ * draws them itself.
+ *
+ * Each ring has a single writer, its CPU with interrupts off, and
+ * overwrites its oldest record when full. Readers take no lock: every
+ * slot carries a sequence word that is odd while being written, so a
+ * reader that raced with an overwrite sees the change and counts the
+ * record as lost.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#ifndef MEOW_DMESG_H
+#define MEOW_DMESG_H
+
+#include <stdint.h>
+#include "meow_error_definitions.h"
+#include "meow_percpu.h"
+
+/* ============================================================================
+ * DMESG CONSTANTS
+ * ============================================================================ */
+
+#define MEOW_DMESG_RECORDS          64      /* Per CPU, power of two */
+#define MEOW_DMESG_TEXT_SIZE        232     /* Including NUL; longer lines are cut */
+#define MEOW_DMESG_DRAIN_MS         10      /* Console kitten's nap between passes */
+
+/* ============================================================================
+ * DMESG TYPES
+ * ============================================================================ */
+
+/**
+ * meow_dmesg_record - One log message as stored
+ */
+typedef struct meow_dmesg_record {
+    uint64_t timestamp_ns;
+    uint32_t seq;                       /* Per CPU, counts from 0 */
+    uint8_t level;                      /* meow_log_level_t */
+    uint8_t cpu;
+    uint16_t length;                    /* Of text, without the NUL */
+    char text[MEOW_DMESG_TEXT_SIZE];
+} meow_dmesg_record_t;
+
+/**
+ * meow_dmesg_iter - A reader's position in every CPU's ring
+ */
+typedef struct meow_dmesg_iter {
+    uint32_t next[MEOW_PERCPU_MAX_CPUS];
+    uint32_t lost;                      /* Overwritten before they were read */
+} meow_dmesg_iter_t;
+
+/* ============================================================================
+ * DMESG INTERFACE
+ * ============================================================================ */
+
+/**
+ * meow_dmesg_log - Store a formatted message and see that it gets drawn
+ * @level: Cat log level
+ * @text: Message without prefix or newline
+ * @length: Bytes of @text
+ *
+ * Safe from any context, including interrupt handlers.
+ */
+void meow_dmesg_log(uint8_t level, const char* text, uint32_t length);
+
+/**
+ * meow_dmesg_flush - Draw every record not drawn yet
+ *
+ * Returns at once if another context is drawing; that one picks up
+ * whatever was stored meanwhile.
+ */
+void meow_dmesg_flush(void);
+
+/**
+ * meow_dmesg_start_drain - Hand console drawing to a low priority kitten
+ *
+ * Needs the thread subsystem and the timer wheel.
+ */
+meow_error_t meow_dmesg_start_drain(void);
+
+/**
+ * meow_dmesg_iter_init - Position @iter at the oldest retained records
+ */
+void meow_dmesg_iter_init(meow_dmesg_iter_t* iter);
+
+/**
+ * meow_dmesg_read - Copy out the next record in timestamp order
+ * @iter: Reader position from meow_dmesg_iter_init()
+ * @record: Filled in on success
+ *
+ * Returns 1 if a record was read, 0 once every ring is exhausted.
+ */
+uint8_t meow_dmesg_read(meow_dmesg_iter_t* iter, meow_dmesg_record_t* record);
+
+/**
+ * meow_dmesg - Print the retained history with timestamps and CPUs
+ */
+void meow_dmesg(void);
+
+#endif /* MEOW_DMESG_H */
@@ -7,6 +7,12 @@
 #include "meow_util.h"
 #include "meow_error_definitions.h"
 #include "meow_multiboot.h"
+#include "meow_tick.h"
+#include "meow_timer.h"
+#include "meow_thread.h"
+#include "meow_percpu.h"
+#include "meow_dmesg.h"
+#include "../advanced/hal/meow_hal_interface.h"
 
 /* Forward declarations for HAL and memory management */
 extern meow_error_t hal_init(multiboot_info_t* mbi);
@@ -149,6 +155,17 @@ static void test_memory_allocation(void) {
         meow_log(MEOW_LOG_YOWL, "Failed to allocate large cat space - cats need more territory!");
     }
 
+    /* Test an allocation bigger than one buddy block (4MB) */
+    void* huge_space = meow_heap_alloc(6 * 1024 * 1024);
+    if (huge_space) {
+        meow_log(MEOW_LOG_CHIRP, "Huge cat space (6MB) allocated at 0x%x", (uint32_t)huge_space);
+        meow_memset(huge_space, 0, 6 * 1024 * 1024);
+        meow_heap_free(huge_space);
+        meow_log(MEOW_LOG_CHIRP, "Huge cat space freed successfully");
+    } else {
+        meow_log(MEOW_LOG_YOWL, "Failed to allocate huge cat space - the colony is too big!");
+    }
+
     meow_log(MEOW_LOG_CHIRP, "Memory allocation tests completed - cats are content!");
 }
 
@@ -272,13 +289,26 @@ static void enter_cat_main_loop(void) {
             }
         }
 
-        /* Brief CPU rest (cat nap) to prevent busy-waiting */
+        /* Brief CPU rest (cat nap), other kittens get the CPU meanwhile */
         if (activity_counter % 50000 == 0) {
-            asm volatile("hlt");
+            if (meow_sleep(10) != MEOW_SUCCESS) {
+                meow_tick_idle();
+            }
         }
     }
 }
 
+/* Where the other CPUs end up once the HAL has started them. Each starts
+ * its own tick for time slices, then waits for the scheduler and joins
+ * it with an idle thread of its own. */
+static void secondary_cpu_main(void) {
+    if (HAL_TIMER_OP_SAFE(start_local, MEOW_ERROR_NOT_SUPPORTED) != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_HISS, "CPU %u has no tick - its kittens run until they block",
+                 meow_this_cpu());
+    }
+    meow_thread_start_cpu();
+}
+
 /* ============================================================================
  * MAIN KERNEL ENTRY POINT
  * ============================================================================ */
@@ -346,6 +376,13 @@ void kernel_main(uint32_t magic, multiboot_info_t* multiboot_info) {
         meow_panic("Critical HAL initialization failure");
     }
     meow_log(MEOW_LOG_CHIRP, "HAL initialized - cats can now control hardware!");
+
+    /* A serial console takes the full log; the screen keeps the warnings */
+    if (HAL_DEBUG_OP_SAFE(init, MEOW_ERROR_NOT_SUPPORTED) == MEOW_SUCCESS) {
+        meow_console_use_debug_port(1);
+        meow_log(MEOW_LOG_CHIRP, "Serial console up - full log on the debug port");
+        meow_log_set_vga_level(MEOW_LOG_HISS);
+    }
     terminal_writestring("\n");
 
     /* Step 2: Initialize Cat Memory Management System */
@@ -383,6 +420,31 @@ void kernel_main(uint32_t magic, multiboot_info_t* multiboot_info) {
     terminal_writestring("==== MeowKernel initialization COMPLETE! ====\n\n");
     set_text_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
 
+    /* Other CPUs need their per-CPU areas before they come up */
+    if (meow_percpu_init() != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_HISS, "Per-CPU setup failed - running on the boot CPU only");
+    } else if (HAL_CPU_OP_SAFE(start_secondary_cpus, MEOW_ERROR_NOT_SUPPORTED,
+                               secondary_cpu_main) != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_MEOW, "Running on the boot CPU only");
+    }
+
+    if (meow_tick_init() != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_HISS, "Tick setup failed - idle keeps the periodic tick");
+    } else if (meow_timer_subsystem_init() != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_HISS, "Timer wheel setup failed - no kernel timers");
+    }
+
+    if (meow_thread_subsystem_init() != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_HISS, "Thread setup failed - running as a single kitten");
+    } else if (meow_dmesg_start_drain() != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_HISS, "Console kitten missing - messages are drawn as they are logged");
+    }
+
+    /* Interrupts stay off until every subsystem is up */
+    if (hal_cpu_enable_interrupts() != MEOW_SUCCESS) {
+        meow_log(MEOW_LOG_HISS, "Could not enable interrupts - the timer stays quiet");
+    }
+
     /* Enter the main kernel loop */
     enter_cat_main_loop();
 }
@@ -0,0 +1,140 @@
+/* kernel/meow_lock.c - MeowKernel Lock Statistics
+ *
+ * The locks themselves are inline in meow_lock.h. This file holds the
+ * interrupt state helpers they share and the out-of-line statistics
+ * hooks used when MEOW_LOCK_STATS is enabled.
+ *
+ * Hold times are taken from the trace clock rather than the tick
+ * clock, since the tick clock can itself sit behind a lock, and are
+ * only converted to nanoseconds when printed. Class counters are shared
+ * by every lock of the class, so they are updated atomically.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "meow_lock.h"
+#include "meow_trace.h"
+#include "meow_util.h"
+#include "../advanced/hal/meow_hal_interface.h"
+
+/* Every class that has been used at least once */
+static meow_lock_class_t* volatile lock_classes = NULL;
+
+/* ============================================================================
+ * INTERRUPT STATE
+ * ============================================================================ */
+
+uint32_t meow_irq_save(void) {
+    uint32_t flags = HAL_CPU_OP_SAFE(get_interrupt_flags, 0);
+    HAL_CPU_OP_SAFE(disable_interrupts, MEOW_ERROR_NOT_SUPPORTED);
+    return flags;
+}
+
+void meow_irq_restore(uint32_t flags) {
+    HAL_CPU_OP_SAFE(set_interrupt_flags, MEOW_ERROR_NOT_SUPPORTED, flags);
+}
+
+/* ============================================================================
+ * STATISTICS
+ * ============================================================================ */
+
+static void lock_class_register_internal(meow_lock_class_t* lock_class) {
+    if (meow_atomic_xchg_u32(&lock_class->registered, 1)) {
+        return;
+    }
+
+    meow_lock_class_t* head;
+    do {
+        head = lock_classes;
+        lock_class->next = head;
+    } while (meow_atomic_cmpxchg_ptr((void* volatile*)&lock_classes, head, lock_class) != head);
+}
+
+/* Add to a 64-bit total kept as two words, carrying into the high word */
+static void lock_stat_add_internal(volatile uint32_t* low, volatile uint32_t* high,
+                                   uint32_t value) {
+    uint32_t old = meow_atomic_fetch_add_u32(low, value);
+    if (old + value < old) {
+        meow_atomic_fetch_add_u32(high, 1);
+    }
+}
+
+static uint64_t lock_stat_read_internal(const volatile uint32_t* low,
+                                        const volatile uint32_t* high) {
+    uint32_t before, after, value;
+    do {
+        before = *high;
+        value = *low;
+        after = *high;
+    } while (before != after);
+    return ((uint64_t)after << 32) | value;
+}
+
+/* Trace clock cycles to nanoseconds; @khz is the clock rate */
+static uint32_t lock_stat_ns_internal(uint64_t cycles, uint32_t khz) {
+    uint64_t ns = cycles * 1000000ULL / khz;
+    return ns > 0xFFFFFFFFULL ? 0xFFFFFFFF : (uint32_t)ns;
+}
+
+void meow_lock_stat_acquired(meow_lock_class_t* lock_class, uint64_t* acquired_at,
+                             uint32_t spins) {
+    if (!lock_class) {
+        return;
+    }
+    if (!lock_class->registered) {
+        lock_class_register_internal(lock_class);
+    }
+
+    meow_atomic_fetch_add_u32(&lock_class->acquisitions, 1);
+    if (spins) {
+        meow_atomic_fetch_add_u32(&lock_class->contended, 1);
+        meow_atomic_fetch_add_u32(&lock_class->spins, spins);
+    }
+    *acquired_at = meow_trace_clock();
+}
+
+void meow_lock_stat_released(meow_lock_class_t* lock_class, uint64_t acquired_at) {
+    if (!lock_class) {
+        return;
+    }
+
+    uint64_t elapsed = meow_trace_clock() - acquired_at;
+    uint32_t held = elapsed > 0xFFFFFFFFULL ? 0xFFFFFFFF : (uint32_t)elapsed;
+    lock_stat_add_internal(&lock_class->hold_total_low, &lock_class->hold_total_high, held);
+
+    uint32_t max = lock_class->hold_max;
+    while (held > max) {
+        uint32_t seen = meow_atomic_cmpxchg_u32(&lock_class->hold_max, max, held);
+        if (seen == max) {
+            break;
+        }
+        max = seen;
+    }
+}
+
+void meow_lock_print_stats(void) {
+    if (!MEOW_LOCK_STATS) {
+        meow_printf("Lock statistics are not built in (LOCK_STATS=1)\n");
+        return;
+    }
+
+    uint32_t khz = HAL_CPU_OP_SAFE(get_cpu_frequency, 0);
+    const char* unit = khz ? "ns" : "cycles";
+
+    meow_printf("Lock classes:\n");
+    for (meow_lock_class_t* lock_class = lock_classes; lock_class; lock_class = lock_class->next) {
+        uint32_t taken = lock_class->acquisitions;
+        uint64_t total = lock_stat_read_internal(&lock_class->hold_total_low,
+                                                 &lock_class->hold_total_high);
+        uint64_t avg_hold = taken ? total / taken : 0;
+        uint64_t max_hold = lock_class->hold_max;
+
+        if (khz) {
+            avg_hold = lock_stat_ns_internal(avg_hold, khz);
+            max_hold = lock_stat_ns_internal(max_hold, khz);
+        }
+        meow_printf("  %s: %u taken, %u contended, %u spins, hold avg %u %s max %u %s\n",
+                    lock_class->name, taken, lock_class->contended, lock_class->spins,
+                    (uint32_t)avg_hold, unit, (uint32_t)max_hold, unit);
+    }
+}
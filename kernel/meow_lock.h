@@ -0,0 +1,282 @@
+/* kernel/meow_lock.h - MeowKernel Locks
+ *
+ * Three kinds of lock, all busy-waiting:
+ *
+ *   meow_spinlock_t     test-and-test-and-set; cheapest, unfair
+ *   meow_ticket_lock_t  FIFO order, every waiter spins on one word
+ *   meow_mcs_lock_t     FIFO order, each waiter spins on its own node
+ *
+ * The _irqsave variants also disable interrupts on this CPU and must be
+ * used for anything an interrupt handler can take.
+ *
+ * Built with MEOW_LOCK_STATS=1, every lock names a lock class that
+ * counts acquisitions, contended acquisitions, spin iterations and hold
+ * times; meow_lock_print_stats() lists the classes that were used.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#ifndef MEOW_LOCK_H
+#define MEOW_LOCK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "meow_error_definitions.h"
+#include "../advanced/hal/meow_hal_atomic.h"
+
+#ifndef MEOW_LOCK_STATS
+#define MEOW_LOCK_STATS 0
+#endif
+
+/* ============================================================================
+ * LOCK CLASSES
+ * ============================================================================ */
+
+/**
+ * meow_lock_class - Statistics shared by every lock of one kind
+ *
+ * Only filled in when MEOW_LOCK_STATS is enabled. A class puts itself on
+ * the global list the first time one of its locks is taken.
+ */
+typedef struct meow_lock_class {
+    const char* name;
+    struct meow_lock_class* next;
+    volatile uint32_t registered;
+    volatile uint32_t acquisitions;
+    volatile uint32_t contended;        /* Acquisitions that had to wait */
+    volatile uint32_t spins;            /* Wait loop iterations */
+    volatile uint32_t hold_total_low;   /* Hold time in trace clock cycles, */
+    volatile uint32_t hold_total_high;  /* split so it can be added atomically */
+    volatile uint32_t hold_max;
+} meow_lock_class_t;
+
+/* Define a lock class; unused when statistics are compiled out */
+#define MEOW_LOCK_CLASS(var, class_name) \
+    static meow_lock_class_t var __attribute__((unused)) = { (class_name), NULL, 0, 0, 0, 0, 0, 0, 0 }
+
+#if MEOW_LOCK_STATS
+#define MEOW_LOCK_STATS_INIT(cls)   , (cls), 0
+#define MEOW_LOCK_STATS_FIELDS      meow_lock_class_t* lock_class; uint64_t acquired_at;
+#else
+#define MEOW_LOCK_STATS_INIT(cls)
+#define MEOW_LOCK_STATS_FIELDS
+#endif
+
+/* ============================================================================
+ * LOCK TYPES
+ * ============================================================================ */
+
+typedef struct meow_spinlock {
+    volatile uint32_t locked;
+    MEOW_LOCK_STATS_FIELDS
+} meow_spinlock_t;
+
+typedef struct meow_ticket_lock {
+    meow_atomic_t next;                 /* Next ticket to hand out */
+    volatile uint32_t owner;            /* Ticket being served */
+    MEOW_LOCK_STATS_FIELDS
+} meow_ticket_lock_t;
+
+/**
+ * meow_mcs_node - One waiter's place in an MCS queue
+ *
+ * Lives on the caller's stack from lock to unlock.
+ */
+typedef struct meow_mcs_node {
+    struct meow_mcs_node* volatile next;
+    volatile uint32_t locked;
+} meow_mcs_node_t;
+
+typedef struct meow_mcs_lock {
+    meow_mcs_node_t* volatile tail;     /* Last waiter, NULL when free */
+    MEOW_LOCK_STATS_FIELDS
+} meow_mcs_lock_t;
+
+#define MEOW_SPINLOCK_INIT(cls)     { 0 MEOW_LOCK_STATS_INIT(cls) }
+#define MEOW_TICKET_LOCK_INIT(cls)  { MEOW_ATOMIC_INIT(0), 0 MEOW_LOCK_STATS_INIT(cls) }
+#define MEOW_MCS_LOCK_INIT(cls)     { NULL MEOW_LOCK_STATS_INIT(cls) }
+
+/* ============================================================================
+ * STATISTICS HOOKS
+ * ============================================================================ */
+
+void meow_lock_stat_acquired(meow_lock_class_t* lock_class, uint64_t* acquired_at,
+                             uint32_t spins);
+void meow_lock_stat_released(meow_lock_class_t* lock_class, uint64_t acquired_at);
+void meow_lock_print_stats(void);
+
+#if MEOW_LOCK_STATS
+#define MEOW_LOCK_ACQUIRED(lock, spins) \
+    meow_lock_stat_acquired((lock)->lock_class, &(lock)->acquired_at, (spins))
+#define MEOW_LOCK_RELEASED(lock) \
+    meow_lock_stat_released((lock)->lock_class, (lock)->acquired_at)
+#else
+#define MEOW_LOCK_ACQUIRED(lock, spins)     ((void)(spins))
+#define MEOW_LOCK_RELEASED(lock)            ((void)0)
+#endif
+
+/* ============================================================================
+ * INTERRUPT STATE
+ * ============================================================================ */
+
+/* Disable interrupts on this CPU, returning the previous state */
+uint32_t meow_irq_save(void);
+void meow_irq_restore(uint32_t flags);
+
+/* ============================================================================
+ * SPINLOCK
+ * ============================================================================ */
+
+static inline void meow_spin_init(meow_spinlock_t* lock, meow_lock_class_t* lock_class) {
+    lock->locked = 0;
+#if MEOW_LOCK_STATS
+    lock->lock_class = lock_class;
+    lock->acquired_at = 0;
+#else
+    (void)lock_class;
+#endif
+}
+
+static inline void meow_spin_lock(meow_spinlock_t* lock) {
+    uint32_t spins = 0;
+
+    while (meow_atomic_xchg_u32(&lock->locked, 1)) {
+        /* Wait with plain reads so the line stays shared */
+        while (lock->locked) {
+            meow_cpu_relax();
+            spins++;
+        }
+    }
+    MEOW_LOCK_ACQUIRED(lock, spins);
+}
+
+/* Returns 1 if the lock was taken */
+static inline uint8_t meow_spin_trylock(meow_spinlock_t* lock) {
+    if (lock->locked || meow_atomic_xchg_u32(&lock->locked, 1)) {
+        return 0;
+    }
+    MEOW_LOCK_ACQUIRED(lock, 0);
+    return 1;
+}
+
+static inline void meow_spin_unlock(meow_spinlock_t* lock) {
+    MEOW_LOCK_RELEASED(lock);
+    meow_store_release_u32(&lock->locked, 0);
+}
+
+static inline uint32_t meow_spin_lock_irqsave(meow_spinlock_t* lock) {
+    uint32_t flags = meow_irq_save();
+    meow_spin_lock(lock);
+    return flags;
+}
+
+static inline void meow_spin_unlock_irqrestore(meow_spinlock_t* lock, uint32_t flags) {
+    meow_spin_unlock(lock);
+    meow_irq_restore(flags);
+}
+
+/* ============================================================================
+ * TICKET LOCK
+ * ============================================================================ */
+
+static inline void meow_ticket_init(meow_ticket_lock_t* lock, meow_lock_class_t* lock_class) {
+    meow_atomic_set(&lock->next, 0);
+    lock->owner = 0;
+#if MEOW_LOCK_STATS
+    lock->lock_class = lock_class;
+    lock->acquired_at = 0;
+#else
+    (void)lock_class;
+#endif
+}
+
+static inline void meow_ticket_lock(meow_ticket_lock_t* lock) {
+    uint32_t ticket = meow_atomic_fetch_add(&lock->next, 1);
+    uint32_t spins = 0;
+
+    while (meow_load_acquire_u32(&lock->owner) != ticket) {
+        meow_cpu_relax();
+        spins++;
+    }
+    MEOW_LOCK_ACQUIRED(lock, spins);
+}
+
+static inline void meow_ticket_unlock(meow_ticket_lock_t* lock) {
+    MEOW_LOCK_RELEASED(lock);
+    /* Only the holder writes owner */
+    meow_store_release_u32(&lock->owner, lock->owner + 1);
+}
+
+static inline uint32_t meow_ticket_lock_irqsave(meow_ticket_lock_t* lock) {
+    uint32_t flags = meow_irq_save();
+    meow_ticket_lock(lock);
+    return flags;
+}
+
+static inline void meow_ticket_unlock_irqrestore(meow_ticket_lock_t* lock, uint32_t flags) {
+    meow_ticket_unlock(lock);
+    meow_irq_restore(flags);
+}
+
+/* ============================================================================
+ * MCS LOCK
+ * ============================================================================ */
+
+static inline void meow_mcs_init(meow_mcs_lock_t* lock, meow_lock_class_t* lock_class) {
+    lock->tail = NULL;
+#if MEOW_LOCK_STATS
+    lock->lock_class = lock_class;
+    lock->acquired_at = 0;
+#else
+    (void)lock_class;
+#endif
+}
+
+static inline void meow_mcs_lock(meow_mcs_lock_t* lock, meow_mcs_node_t* node) {
+    uint32_t spins = 0;
+
+    node->next = NULL;
+    node->locked = 1;
+
+    meow_mcs_node_t* prev = (meow_mcs_node_t*)meow_atomic_xchg_ptr((void* volatile*)&lock->tail,
+                                                                   node);
+    if (prev) {
+        /* Queue behind the previous waiter and spin on our own node */
+        prev->next = node;
+        while (meow_load_acquire_u32(&node->locked)) {
+            meow_cpu_relax();
+            spins++;
+        }
+    }
+    MEOW_LOCK_ACQUIRED(lock, spins);
+}
+
+static inline void meow_mcs_unlock(meow_mcs_lock_t* lock, meow_mcs_node_t* node) {
+    MEOW_LOCK_RELEASED(lock);
+
+    if (!node->next) {
+        /* No known successor: try to mark the lock free */
+        if (meow_atomic_cmpxchg_ptr((void* volatile*)&lock->tail, node, NULL) == node) {
+            return;
+        }
+        /* A waiter swapped itself in but hasn't linked up yet */
+        while (!node->next) {
+            meow_cpu_relax();
+        }
+    }
+    meow_store_release_u32(&node->next->locked, 0);
+}
+
+static inline uint32_t meow_mcs_lock_irqsave(meow_mcs_lock_t* lock, meow_mcs_node_t* node) {
+    uint32_t flags = meow_irq_save();
+    meow_mcs_lock(lock, node);
+    return flags;
+}
+
+static inline void meow_mcs_unlock_irqrestore(meow_mcs_lock_t* lock, meow_mcs_node_t* node,
+                                              uint32_t flags) {
+    meow_mcs_unlock(lock, node);
+    meow_irq_restore(flags);
+}
+
+#endif /* MEOW_LOCK_H */
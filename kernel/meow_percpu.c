@@ -0,0 +1,95 @@
+/* kernel/meow_percpu.c - MeowKernel Per-CPU Areas
+ *
+ * The copies for CPUs other than 0 come from one territory run, each
+ * rounded up to a cache line so no two CPUs share one. The dynamic
+ * reserve is a per-CPU array handed out by a bump allocator; because
+ * every copy has the same layout, a piece of it is valid on every CPU.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "meow_percpu.h"
+#include "meow_util.h"
+#include "meow_lock.h"
+#include "../advanced/hal/meow_hal_interface.h"
+#include "../advanced/mm/meow_physical_memory.h"
+
+MEOW_DEFINE_PER_CPU(uint32_t, meow_cpu_number) = 0;
+MEOW_DEFINE_PER_CPU(uintptr_t, meow_percpu_this_offset) = 0;
+static MEOW_DEFINE_PER_CPU(uint8_t, percpu_dynamic[MEOW_PERCPU_DYNAMIC_SIZE])
+    __attribute__((aligned(MEOW_PERCPU_ALIGN)));
+
+uintptr_t meow_percpu_offsets[MEOW_PERCPU_MAX_CPUS];
+
+/* Global allocator state */
+MEOW_LOCK_CLASS(percpu_lock_class, "percpu-alloc");
+static meow_spinlock_t percpu_lock = MEOW_SPINLOCK_INIT(&percpu_lock_class);
+static uint32_t percpu_dynamic_used = 0;
+static uint8_t percpu_initialized = 0;
+
+/* ============================================================================
+ * PER-CPU INTERFACE
+ * ============================================================================ */
+
+meow_error_t meow_percpu_init(void) {
+    if (percpu_initialized) {
+        return MEOW_ERROR_ALREADY_INITIALIZED;
+    }
+
+    uint32_t area_size = MEOW_ALIGN_UP((uint32_t)(__meow_percpu_end - __meow_percpu_start),
+                                       MEOW_PERCPU_ALIGN);
+    uint32_t bytes = area_size * (MEOW_PERCPU_MAX_CPUS - 1);
+    uint32_t territories = (bytes + TERRITORY_SIZE - 1) / TERRITORY_SIZE;
+
+    uint32_t base = purr_alloc_territory_run(territories);
+    if (!base) {
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+    meow_memset((void*)base, 0, bytes);
+
+    /* CPU 0 keeps the section itself */
+    for (uint32_t cpu = 0; cpu < MEOW_PERCPU_MAX_CPUS; cpu++) {
+        uintptr_t area = cpu == 0 ? (uintptr_t)__meow_percpu_start :
+                                    base + (cpu - 1) * area_size;
+        meow_percpu_offsets[cpu] = area - (uintptr_t)__meow_percpu_start;
+        per_cpu(meow_cpu_number, cpu) = cpu;
+        per_cpu(meow_percpu_this_offset, cpu) = meow_percpu_offsets[cpu];
+
+        meow_error_t result = HAL_CPU_OP_SAFE(set_percpu_offset, MEOW_ERROR_NOT_SUPPORTED,
+                                              cpu, meow_percpu_offsets[cpu]);
+        if (result != MEOW_SUCCESS) {
+            purr_free_territory_run(base, territories);
+            return result;
+        }
+    }
+
+    percpu_initialized = 1;
+    meow_log(MEOW_LOG_CHIRP, "Per-CPU: %u byte areas for %u CPUs at 0x%08x",
+             area_size, MEOW_PERCPU_MAX_CPUS, base);
+    return MEOW_SUCCESS;
+}
+
+void* meow_percpu_alloc(size_t size, size_t align) {
+    if (size == 0) {
+        return NULL;
+    }
+    if (align == 0) {
+        align = sizeof(void*);
+    }
+    if ((align & (align - 1)) != 0 || align > MEOW_PERCPU_ALIGN) {
+        return NULL;
+    }
+
+    uint32_t flags = meow_spin_lock_irqsave(&percpu_lock);
+    uint32_t offset = MEOW_ALIGN_UP(percpu_dynamic_used, (uint32_t)align);
+    if (offset + size > MEOW_PERCPU_DYNAMIC_SIZE) {
+        meow_spin_unlock_irqrestore(&percpu_lock, flags);
+        meow_log(MEOW_LOG_HISS, "Per-CPU: reserve exhausted (%u bytes asked)", (uint32_t)size);
+        return NULL;
+    }
+    percpu_dynamic_used = offset + (uint32_t)size;
+    meow_spin_unlock_irqrestore(&percpu_lock, flags);
+
+    /* Nothing has written this part of any copy yet, so it is zero */
+    return &percpu_dynamic[offset];
+}
@@ -0,0 +1,163 @@
+/* kernel/meow_percpu.h - MeowKernel Per-CPU Data
+ *
+ * Per-CPU variables live in the .meow_percpu section. The section itself
+ * is CPU 0's copy; every other CPU gets a zeroed copy of the same layout
+ * from meow_percpu_init(). A CPU finds its copy through an offset the
+ * HAL keeps in a register: the base of a GDT segment loaded in %fs on
+ * x86, TPIDR_EL1 on ARM64. The offset is 0 on CPU 0, so per-CPU
+ * variables work from the first instruction of the kernel.
+ *
+ * On x86 this_cpu_read/write/add compile to a single %fs-relative
+ * instruction, which is also atomic with respect to interrupts on the
+ * same CPU. ARM64 needs an mrs and a load or store.
+ *
+ * Only scalars of 1, 2 or 4 bytes can be accessed directly; use
+ * this_cpu_ptr() for anything larger, with preemption disabled.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#ifndef MEOW_PERCPU_H
+#define MEOW_PERCPU_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "meow_error_definitions.h"
+
+/* ============================================================================
+ * PER-CPU CONSTANTS
+ * ============================================================================ */
+
+#define MEOW_PERCPU_MAX_CPUS        16      /* Must cover X86_MAX_CPUS */
+#define MEOW_PERCPU_DYNAMIC_SIZE    2048    /* Bytes for meow_percpu_alloc */
+#define MEOW_PERCPU_ALIGN           64      /* Copies start on a cache line */
+
+/* ============================================================================
+ * DEFINING PER-CPU VARIABLES
+ * ============================================================================ */
+
+/* Initialisers only apply to CPU 0; other CPUs start from zero */
+#define MEOW_DEFINE_PER_CPU(type, name) \
+    __attribute__((section(".meow_percpu"))) type name
+#define MEOW_DECLARE_PER_CPU(type, name) \
+    extern type name
+
+/* Section bounds from the linker script */
+extern char __meow_percpu_start[];
+extern char __meow_percpu_end[];
+
+/* Each CPU's copy minus the section address, by CPU number */
+extern uintptr_t meow_percpu_offsets[MEOW_PERCPU_MAX_CPUS];
+
+MEOW_DECLARE_PER_CPU(uint32_t, meow_cpu_number);
+MEOW_DECLARE_PER_CPU(uintptr_t, meow_percpu_this_offset);
+
+/* Never defined: referencing it turns an unsupported size into a link error */
+extern void meow_percpu_bad_size(void);
+
+/* ============================================================================
+ * ACCESSORS
+ * ============================================================================ */
+
+/* Another CPU's copy of a per-CPU object */
+#define per_cpu_ptr(ptr, cpu) \
+    ((__typeof__(ptr))((uintptr_t)(ptr) + meow_percpu_offsets[(cpu)]))
+#define per_cpu(var, cpu)   (*per_cpu_ptr(&(var), (cpu)))
+
+#if defined(__i386__)
+
+/* %fs bases every CPU's segment at its offset, so the variable's own
+ * address is the operand */
+#define this_cpu_read(var) ({                                                   \
+    union {                                                                     \
+        __typeof__(var) value;                                                  \
+        uint8_t u8;                                                             \
+        uint16_t u16;                                                           \
+        uint32_t u32;                                                           \
+    } pcpu_read_;                                                               \
+    switch (sizeof(var)) {                                                      \
+    case 1: asm volatile("movb %%fs:%1, %0" : "=q"(pcpu_read_.u8) : "m"(var)); break;   \
+    case 2: asm volatile("movw %%fs:%1, %0" : "=r"(pcpu_read_.u16) : "m"(var)); break;  \
+    case 4: asm volatile("movl %%fs:%1, %0" : "=r"(pcpu_read_.u32) : "m"(var)); break;  \
+    default: meow_percpu_bad_size();                                            \
+    }                                                                           \
+    pcpu_read_.value;                                                           \
+})
+
+#define this_cpu_write(var, val) do {                                           \
+    union {                                                                     \
+        __typeof__(var) value;                                                  \
+        uint8_t u8;                                                             \
+        uint16_t u16;                                                           \
+        uint32_t u32;                                                           \
+    } pcpu_write_;                                                              \
+    pcpu_write_.value = (val);                                                  \
+    switch (sizeof(var)) {                                                      \
+    case 1: asm volatile("movb %1, %%fs:%0" : "=m"(var) : "qi"(pcpu_write_.u8)); break;  \
+    case 2: asm volatile("movw %1, %%fs:%0" : "=m"(var) : "ri"(pcpu_write_.u16)); break; \
+    case 4: asm volatile("movl %1, %%fs:%0" : "=m"(var) : "ri"(pcpu_write_.u32)); break; \
+    default: meow_percpu_bad_size();                                            \
+    }                                                                           \
+} while (0)
+
+/* Integer types only */
+#define this_cpu_add(var, val) do {                                             \
+    switch (sizeof(var)) {                                                      \
+    case 1: asm volatile("addb %1, %%fs:%0" : "+m"(var) : "qi"((uint8_t)(val)) : "cc"); break;   \
+    case 2: asm volatile("addw %1, %%fs:%0" : "+m"(var) : "ri"((uint16_t)(val)) : "cc"); break;  \
+    case 4: asm volatile("addl %1, %%fs:%0" : "+m"(var) : "ri"((uint32_t)(val)) : "cc"); break;  \
+    default: meow_percpu_bad_size();                                            \
+    }                                                                           \
+} while (0)
+
+#define this_cpu_ptr(ptr) \
+    ((__typeof__(ptr))((uintptr_t)(ptr) + this_cpu_read(meow_percpu_this_offset)))
+
+#elif defined(__aarch64__)
+
+static inline uintptr_t meow_percpu_offset_internal(void) {
+    uintptr_t offset;
+    asm volatile("mrs %0, tpidr_el1" : "=r"(offset));
+    return offset;
+}
+
+#define this_cpu_ptr(ptr) \
+    ((__typeof__(ptr))((uintptr_t)(ptr) + meow_percpu_offset_internal()))
+#define this_cpu_read(var)          (*(volatile __typeof__(var)*)this_cpu_ptr(&(var)))
+#define this_cpu_write(var, val)    (*(volatile __typeof__(var)*)this_cpu_ptr(&(var)) = (val))
+#define this_cpu_add(var, val)      (*(volatile __typeof__(var)*)this_cpu_ptr(&(var)) += (val))
+
+#else
+#error "meow_percpu.h: no per-CPU access for this architecture"
+#endif
+
+#define this_cpu_inc(var)   this_cpu_add(var, 1)
+
+/* ============================================================================
+ * PER-CPU INTERFACE
+ * ============================================================================ */
+
+/**
+ * meow_percpu_init - Give every possible CPU its own per-CPU area
+ *
+ * Needs the PMM. Must run before secondary CPUs are started; they load
+ * their offset while coming up.
+ */
+meow_error_t meow_percpu_init(void);
+
+/**
+ * meow_percpu_alloc - Allocate a zeroed object in every CPU's area
+ * @size: Bytes per CPU
+ * @align: Power of two alignment, 0 for pointer size
+ *
+ * Returns a per-CPU pointer for this_cpu_ptr/per_cpu_ptr, or NULL once
+ * the MEOW_PERCPU_DYNAMIC_SIZE reserve is used up. Never freed.
+ */
+void* meow_percpu_alloc(size_t size, size_t align);
+
+/* This CPU's number, one %fs-relative load on x86 */
+static inline uint32_t meow_this_cpu(void) {
+    return this_cpu_read(meow_cpu_number);
+}
+
+#endif /* MEOW_PERCPU_H */
@@ -0,0 +1,722 @@
+/* kernel/meow_thread.c - MeowKernel Kernel Threads
+ *
+ * Priority scheduling of kernel threads with a run queue per CPU. Each
+ * queue keeps a FIFO list per priority and a bitmap with one bit per
+ * non-empty list; the next thread is the head of the list named by the
+ * lowest set bit. Threads of equal priority share the CPU round-robin.
+ *
+ * Switching is a HAL call that saves the callee-saved registers on the
+ * old stack and pops them off the new one. Preemption happens on the way
+ * out of an interrupt, after the EOI; every CPU's own tick charges time
+ * slices, and a reschedule IPI gets another CPU there early.
+ *
+ * Each run queue has its own IRQ-safe spinlock. It is held across the
+ * switch itself and released by the thread switched to, which runs on
+ * the same CPU. Threads stay on the CPU they were created on; new ones
+ * go to the least loaded CPU that schedules. The list of all threads
+ * and the zombies have a lock of their own, taken inside a queue lock.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "meow_thread.h"
+#include "meow_tick.h"
+#include "meow_util.h"
+#include "meow_lock.h"
+#include "meow_percpu.h"
+#include "../advanced/hal/meow_hal_interface.h"
+#include "../advanced/mm/meow_slab_allocator.h"
+#include "../advanced/mm/meow_physical_memory.h"
+
+#define THREAD_STACK_SIZE   (TERRITORY_SIZE << MEOW_THREAD_STACK_ORDER)
+#define IDLE_PRIORITY       MEOW_THREAD_PRIORITIES      /* Below every real priority */
+
+/**
+ * meow_runqueue - One CPU's ready threads
+ */
+typedef struct meow_runqueue {
+    meow_spinlock_t lock;               /* Guards the queue and its threads' states */
+    uint32_t bitmap;                    /* Bit n set: list n is non-empty */
+    meow_thread_t* head[MEOW_THREAD_PRIORITIES];
+    meow_thread_t* tail[MEOW_THREAD_PRIORITIES];
+    meow_thread_t* current;
+    meow_thread_t* idle;
+    uint32_t slice_left;
+    volatile uint8_t need_resched;
+    uint64_t last_switch_ns;            /* When current was switched in */
+    volatile uint8_t online;            /* Has an idle thread and takes new threads */
+    meow_sched_stats_t stats;
+} meow_runqueue_t;
+
+/* Global scheduler state */
+static meow_runqueue_t run_queues[MEOW_SCHED_MAX_CPUS];
+static MEOW_DEFINE_PER_CPU(meow_runqueue_t*, cpu_runqueue) = &run_queues[0];
+static MEOW_DEFINE_PER_CPU(uint32_t, preempt_count);   /* Nesting of preempt_disable */
+static meow_cache_t* thread_cache = NULL;
+static meow_thread_t* all_threads = NULL;
+static meow_thread_t* zombie_threads = NULL;
+static void (*switch_context)(void** save_sp, void* next_sp) = NULL;
+static uint32_t next_thread_id = 0;
+static volatile uint32_t threads_initialized = 0;
+
+MEOW_LOCK_CLASS(runqueue_lock_class, "sched-rq");
+MEOW_LOCK_CLASS(threads_lock_class, "sched-threads");
+static meow_spinlock_t threads_lock = MEOW_SPINLOCK_INIT(&threads_lock_class);
+
+/* ============================================================================
+ * INTERNAL HELPERS
+ * ============================================================================ */
+
+static inline uint32_t rq_lock_internal(meow_runqueue_t* rq) {
+    return meow_spin_lock_irqsave(&rq->lock);
+}
+
+static inline void rq_unlock_internal(meow_runqueue_t* rq, uint32_t flags) {
+    meow_spin_unlock_irqrestore(&rq->lock, flags);
+}
+
+/* One %fs-relative load on x86. Threads never change CPUs, so the
+ * answer stays right even if the caller is preempted. */
+static inline meow_runqueue_t* this_rq_internal(void) {
+    return this_cpu_read(cpu_runqueue);
+}
+
+/* Queued threads plus the running one, unless it is idle */
+static inline uint32_t rq_load_internal(meow_runqueue_t* rq) {
+    return rq->stats.nr_ready + (rq->current != rq->idle);
+}
+
+/* Least loaded CPU that schedules, preferring the caller's. The loads are
+ * read unlocked; they only steer placement. */
+static uint32_t rq_select_internal(void) {
+    uint32_t self = meow_this_cpu();
+    uint32_t best = self < MEOW_SCHED_MAX_CPUS && run_queues[self].online ? self : 0;
+    uint32_t best_load = rq_load_internal(&run_queues[best]);
+
+    for (uint32_t cpu = 0; cpu < MEOW_SCHED_MAX_CPUS; cpu++) {
+        meow_runqueue_t* rq = &run_queues[cpu];
+        if (rq->online && rq_load_internal(rq) < best_load) {
+            best = cpu;
+            best_load = rq_load_internal(rq);
+        }
+    }
+    return best;
+}
+
+static inline void rq_enqueue_internal(meow_runqueue_t* rq, meow_thread_t* thread) {
+    uint32_t prio = thread->priority;
+
+    thread->next = NULL;
+    if (rq->tail[prio]) {
+        rq->tail[prio]->next = thread;
+    } else {
+        rq->head[prio] = thread;
+        rq->bitmap |= 1U << prio;
+    }
+    rq->tail[prio] = thread;
+    rq->stats.nr_ready++;
+}
+
+/* Unlink a ready thread from wherever it is in its list */
+static void rq_remove_internal(meow_runqueue_t* rq, meow_thread_t* thread) {
+    uint32_t prio = thread->priority;
+    meow_thread_t* prev = NULL;
+
+    for (meow_thread_t* it = rq->head[prio]; it; prev = it, it = it->next) {
+        if (it != thread) {
+            continue;
+        }
+        if (prev) {
+            prev->next = it->next;
+        } else {
+            rq->head[prio] = it->next;
+        }
+        if (rq->tail[prio] == it) {
+            rq->tail[prio] = prev;
+        }
+        if (!rq->head[prio]) {
+            rq->bitmap &= ~(1U << prio);
+        }
+        thread->next = NULL;
+        rq->stats.nr_ready--;
+        return;
+    }
+}
+
+/* Take the most urgent ready thread, or NULL */
+static inline meow_thread_t* rq_pick_internal(meow_runqueue_t* rq) {
+    if (!rq->bitmap) {
+        return NULL;
+    }
+
+    uint32_t prio = (uint32_t)__builtin_ctz(rq->bitmap);
+    meow_thread_t* thread = rq->head[prio];
+    rq->head[prio] = thread->next;
+    if (!rq->head[prio]) {
+        rq->tail[prio] = NULL;
+        rq->bitmap &= ~(1U << prio);
+    }
+    thread->next = NULL;
+    rq->stats.nr_ready--;
+    return thread;
+}
+
+/* Is anything ready at @prio or more urgent? */
+static inline uint8_t rq_has_ready_internal(meow_runqueue_t* rq, uint32_t prio) {
+    if (prio >= MEOW_THREAD_PRIORITIES - 1) {
+        return rq->bitmap != 0;
+    }
+    return (rq->bitmap & ((2U << prio) - 1)) != 0;
+}
+
+/* After dropping the queue lock: have another CPU act on need_resched
+ * now rather than at its next tick */
+static void rq_kick_internal(uint32_t cpu) {
+    if (cpu != meow_this_cpu()) {
+        HAL_CPU_OP_SAFE(send_reschedule, MEOW_ERROR_NOT_SUPPORTED, cpu);
+    }
+}
+
+/* Make @thread ready on its CPU's queue. Queue lock held. */
+static void rq_wake_internal(meow_runqueue_t* rq, meow_thread_t* thread) {
+    thread->state = MEOW_THREAD_READY;
+    rq_enqueue_internal(rq, thread);
+    if (thread->priority < rq->current->priority) {
+        /* Another CPU notices at its next interrupt exit */
+        rq->need_resched = 1;
+    }
+}
+
+/* Pick the next thread and switch to it. This CPU's queue lock must be
+ * held; the chosen thread releases it and restores its own flags. */
+static void schedule_internal(uint8_t preempted) {
+    meow_runqueue_t* rq = this_rq_internal();
+    meow_thread_t* prev = rq->current;
+
+    if (prev->state == MEOW_THREAD_RUNNING) {
+        prev->state = MEOW_THREAD_READY;
+        if (prev != rq->idle) {
+            rq_enqueue_internal(rq, prev);
+        }
+    }
+
+    meow_thread_t* next = rq_pick_internal(rq);
+    if (!next) {
+        next = rq->idle;
+    }
+
+    rq->need_resched = 0;
+    rq->slice_left = MEOW_THREAD_SLICE_TICKS;
+    next->state = MEOW_THREAD_RUNNING;
+    if (next == prev) {
+        return;
+    }
+
+    uint64_t now = meow_tick_now_ns();
+    prev->runtime_ns += now - rq->last_switch_ns;
+    if (prev == rq->idle) {
+        rq->stats.idle_ns += now - rq->last_switch_ns;
+        /* The tick was stopped for idle; busy threads need it back */
+        meow_tick_idle_exit();
+    }
+    rq->last_switch_ns = now;
+
+    if (preempted) {
+        prev->preemptions++;
+        rq->stats.preemptions++;
+    } else {
+        prev->voluntary_switches++;
+    }
+    rq->current = next;
+    next->switches_in++;
+    rq->stats.context_switches++;
+    switch_context(&prev->saved_sp, next->saved_sp);
+}
+
+/* Free threads that have exited. Never runs on a dying thread's stack. */
+static void reap_internal(void) {
+    uint32_t flags = meow_spin_lock_irqsave(&threads_lock);
+    meow_thread_t* dead = zombie_threads;
+    zombie_threads = NULL;
+
+    for (meow_thread_t* thread = dead; thread; thread = thread->next) {
+        meow_thread_t** link = &all_threads;
+        while (*link && *link != thread) {
+            link = &(*link)->all_next;
+        }
+        if (*link) {
+            *link = thread->all_next;
+        }
+    }
+    meow_spin_unlock_irqrestore(&threads_lock, flags);
+
+    /* The allocators have locks of their own */
+    while (dead) {
+        meow_thread_t* thread = dead;
+        dead = thread->next;
+
+        /* A thread exits holding its queue lock and the thread switched to
+         * drops it, so once it is free the dead stack is no longer in use */
+        meow_runqueue_t* rq = &run_queues[thread->cpu];
+        rq_unlock_internal(rq, rq_lock_internal(rq));
+
+        if (thread->stack_base) {
+            purr_free_territories(thread->stack_base, MEOW_THREAD_STACK_ORDER);
+        }
+        meow_cache_free(thread_cache, thread);
+    }
+}
+
+/* First code every new thread runs, still holding its queue's lock from
+ * the switch that brought it here */
+static void thread_bootstrap_internal(void* arg) {
+    meow_thread_t* self = (meow_thread_t*)arg;
+
+    meow_spin_unlock(&run_queues[self->cpu].lock);
+    HAL_CPU_OP_SAFE(enable_interrupts, MEOW_ERROR_NOT_SUPPORTED);
+    self->entry(self->arg);
+    meow_thread_exit();
+}
+
+/* Threads are listed under their own lock, taken inside a queue lock */
+static void thread_list_add_internal(meow_thread_t* thread) {
+    meow_spin_lock(&threads_lock);
+    thread->id = next_thread_id++;
+    thread->all_next = all_threads;
+    all_threads = thread;
+    meow_spin_unlock(&threads_lock);
+}
+
+/* Idle threads are named after their CPU */
+static void idle_name_internal(char* name, uint32_t cpu) {
+    char number[12];
+
+    meow_uint_to_string(cpu, number, 10);
+    meow_strcpy(name, "kitten-idle", MEOW_THREAD_NAME_LENGTH);
+    meow_strcat(name, number);
+}
+
+static meow_thread_t* create_internal(const char* name, meow_thread_fn_t entry, void* arg,
+                                      uint32_t priority, uint32_t cpu) {
+    meow_thread_t* thread = (meow_thread_t*)meow_cache_alloc(thread_cache);
+    uint32_t stack = thread ? purr_alloc_territories(MEOW_THREAD_STACK_ORDER) : 0;
+    if (!stack) {
+        if (thread) {
+            meow_cache_free(thread_cache, thread);
+        }
+        meow_log(MEOW_LOG_HISS, "Thread: No memory for kitten '%s'", name);
+        return NULL;
+    }
+
+    meow_memset(thread, 0, sizeof(*thread));
+    meow_strcpy(thread->name, name, MEOW_THREAD_NAME_LENGTH);
+    thread->priority = priority;
+    thread->cpu = cpu;
+    thread->stack_base = stack;
+    thread->entry = entry;
+    thread->arg = arg;
+    thread->saved_sp = hal_get_ops()->cpu_ops->init_context((void*)(stack + THREAD_STACK_SIZE),
+                                                            thread_bootstrap_internal, thread);
+
+    meow_runqueue_t* rq = &run_queues[cpu];
+    uint32_t flags = rq_lock_internal(rq);
+    thread_list_add_internal(thread);
+
+    /* The idle thread never goes on a queue */
+    uint8_t kick = 0;
+    if (priority == IDLE_PRIORITY) {
+        thread->state = MEOW_THREAD_BLOCKED;
+    } else {
+        rq_wake_internal(rq, thread);
+        kick = rq->need_resched;
+    }
+
+    rq_unlock_internal(rq, flags);
+    if (kick) {
+        rq_kick_internal(cpu);
+    }
+    return thread;
+}
+
+static void idle_thread_internal(void* arg) {
+    (void)arg;
+
+    for (;;) {
+        reap_internal();
+        /* A wakeup from an interrupt switches away in the exit hook */
+        meow_tick_idle();
+        if (this_rq_internal()->bitmap) {
+            meow_yield();
+        }
+    }
+}
+
+/* Per-CPU tick handler: charge the running thread's slice */
+static void thread_tick_internal(uint64_t now_ns) {
+    meow_runqueue_t* rq = this_rq_internal();
+
+    (void)now_ns;
+    if (!rq) {
+        return;
+    }
+
+    /* Interrupts are already off in the tick */
+    meow_spin_lock(&rq->lock);
+    meow_thread_t* current = rq->current;
+    if (current == rq->idle) {
+        if (rq->bitmap) {
+            rq->need_resched = 1;
+        }
+    } else if (rq->slice_left && --rq->slice_left == 0) {
+        /* Alone at its priority it just gets another slice */
+        if (rq_has_ready_internal(rq, current->priority)) {
+            rq->need_resched = 1;
+        } else {
+            rq->slice_left = MEOW_THREAD_SLICE_TICKS;
+        }
+    }
+    meow_spin_unlock(&rq->lock);
+}
+
+/* Interrupt exit hook, after the EOI */
+static void thread_irq_exit_internal(void) {
+    meow_runqueue_t* rq = this_rq_internal();
+
+    /* No queue yet on a CPU that hasn't joined the scheduler */
+    if (rq && rq->need_resched && this_cpu_read(preempt_count) == 0) {
+        meow_spin_lock(&rq->lock);
+        if (rq->need_resched) {
+            schedule_internal(1);
+        }
+        meow_spin_unlock(&rq->lock);
+    }
+}
+
+/* ============================================================================
+ * THREAD INTERFACE
+ * ============================================================================ */
+
+meow_error_t meow_thread_subsystem_init(void) {
+    if (threads_initialized) {
+        return MEOW_ERROR_ALREADY_INITIALIZED;
+    }
+
+    const hal_ops_t* ops = hal_get_ops();
+    if (!ops || !HAL_VALIDATE_OP(ops->cpu_ops, init_context) ||
+        !HAL_VALIDATE_OP(ops->cpu_ops, switch_context) ||
+        !HAL_VALIDATE_OP(ops->interrupt_ops, set_exit_hook)) {
+        return MEOW_ERROR_NOT_SUPPORTED;
+    }
+    switch_context = ops->cpu_ops->switch_context;
+
+    thread_cache = meow_cache_create("kitten-tcb", sizeof(meow_thread_t), 16, NULL);
+    if (!thread_cache) {
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Other CPUs pick up their queue in meow_thread_start_cpu */
+    meow_memset(run_queues, 0, sizeof(run_queues));
+    for (uint32_t cpu = 0; cpu < MEOW_SCHED_MAX_CPUS; cpu++) {
+        meow_spin_init(&run_queues[cpu].lock, &runqueue_lock_class);
+    }
+    meow_runqueue_t* rq = this_rq_internal();
+
+    /* The code running now becomes the first thread, on the boot stack */
+    meow_thread_t* boot = (meow_thread_t*)meow_cache_alloc(thread_cache);
+    if (!boot) {
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+    meow_memset(boot, 0, sizeof(*boot));
+    meow_strcpy(boot->name, "kitten-main", MEOW_THREAD_NAME_LENGTH);
+    boot->id = next_thread_id++;
+    boot->priority = MEOW_THREAD_PRIORITY_NORMAL;
+    boot->state = MEOW_THREAD_RUNNING;
+    boot->switches_in = 1;
+    all_threads = boot;
+    rq->current = boot;
+    rq->slice_left = MEOW_THREAD_SLICE_TICKS;
+    rq->last_switch_ns = meow_tick_now_ns();
+
+    /* Runs whenever the queue is empty */
+    char idle_name[MEOW_THREAD_NAME_LENGTH];
+    idle_name_internal(idle_name, 0);
+    rq->idle = create_internal(idle_name, idle_thread_internal, NULL, IDLE_PRIORITY, 0);
+    if (!rq->idle) {
+        return MEOW_ERROR_OUT_OF_MEMORY;
+    }
+
+    MEOW_RETURN_IF_ERROR(meow_tick_register_cpu_handler(thread_tick_internal));
+    MEOW_RETURN_IF_ERROR(ops->interrupt_ops->set_exit_hook(thread_irq_exit_internal));
+    rq->online = 1;
+    meow_store_release_u32(&threads_initialized, 1);
+
+    meow_log(MEOW_LOG_CHIRP, "Thread: Kittens ready (%u KB stacks, %u priorities, %u tick slices)",
+             THREAD_STACK_SIZE / 1024, MEOW_THREAD_PRIORITIES, MEOW_THREAD_SLICE_TICKS);
+    return MEOW_SUCCESS;
+}
+
+meow_thread_t* meow_thread_create(const char* name, meow_thread_fn_t entry, void* arg) {
+    if (!threads_initialized || !entry) {
+        return NULL;
+    }
+
+    reap_internal();
+    return create_internal(name ? name : "kitten", entry, arg, MEOW_THREAD_PRIORITY_NORMAL,
+                           rq_select_internal());
+}
+
+void meow_thread_start_cpu(void) {
+    uint32_t cpu = meow_this_cpu();
+
+    while (!meow_load_acquire_u32(&threads_initialized)) {
+        meow_cpu_relax();
+    }
+
+    meow_thread_t* idle = cpu < MEOW_SCHED_MAX_CPUS ?
+                          (meow_thread_t*)meow_cache_alloc(thread_cache) : NULL;
+    if (!idle) {
+        meow_log(MEOW_LOG_HISS, "Thread: CPU %u stays out of the scheduler", cpu);
+        for (;;) {
+            hal_cpu_halt();
+        }
+    }
+
+    /* Like the boot thread, the code running now becomes a thread and
+     * keeps the stack it was started on */
+    meow_memset(idle, 0, sizeof(*idle));
+    idle_name_internal(idle->name, cpu);
+    idle->priority = IDLE_PRIORITY;
+    idle->cpu = cpu;
+    idle->state = MEOW_THREAD_RUNNING;
+    idle->switches_in = 1;
+
+    meow_runqueue_t* rq = &run_queues[cpu];
+    uint32_t flags = rq_lock_internal(rq);
+    thread_list_add_internal(idle);
+    rq->current = idle;
+    rq->idle = idle;
+    rq->slice_left = MEOW_THREAD_SLICE_TICKS;
+    rq->last_switch_ns = meow_tick_now_ns();
+    this_cpu_write(cpu_runqueue, rq);
+    rq->online = 1;
+    rq_unlock_internal(rq, flags);
+
+    meow_log(MEOW_LOG_CHIRP, "Thread: CPU %u joined the scheduler", cpu);
+    HAL_CPU_OP_SAFE(enable_interrupts, MEOW_ERROR_NOT_SUPPORTED);
+    idle_thread_internal(NULL);
+    for (;;) {
+        /* The idle loop never returns */
+    }
+}
+
+meow_error_t meow_thread_set_priority(meow_thread_t* thread, uint32_t priority) {
+    if (!thread) {
+        return MEOW_ERROR_NULL_POINTER;
+    }
+    if (priority >= MEOW_THREAD_PRIORITIES) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    meow_runqueue_t* rq = &run_queues[thread->cpu];
+    uint32_t flags = rq_lock_internal(rq);
+    if (thread == rq->idle) {
+        rq_unlock_internal(rq, flags);
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    if (thread->state == MEOW_THREAD_READY) {
+        rq_remove_internal(rq, thread);
+        thread->priority = priority;
+        rq_enqueue_internal(rq, thread);
+    } else {
+        thread->priority = priority;
+    }
+
+    /* Something ready may now outrank the running thread */
+    uint8_t kick = 0;
+    if (rq->bitmap && (uint32_t)__builtin_ctz(rq->bitmap) < rq->current->priority) {
+        rq->need_resched = 1;
+        kick = 1;
+    }
+    rq_unlock_internal(rq, flags);
+    if (kick) {
+        rq_kick_internal(thread->cpu);
+    }
+    return MEOW_SUCCESS;
+}
+
+void meow_yield(void) {
+    meow_runqueue_t* rq = this_rq_internal();
+    if (!threads_initialized || !rq) {
+        return;
+    }
+
+    uint32_t flags = rq_lock_internal(rq);
+    schedule_internal(0);
+    rq_unlock_internal(rq, flags);
+}
+
+void meow_thread_block(void) {
+    meow_runqueue_t* rq = this_rq_internal();
+    if (!threads_initialized || !rq) {
+        return;
+    }
+
+    uint32_t flags = rq_lock_internal(rq);
+    meow_thread_t* current = rq->current;
+    if (current->wake_pending) {
+        /* Woken from another CPU between its test and this call */
+        current->wake_pending = 0;
+        rq_unlock_internal(rq, flags);
+        return;
+    }
+    if (current == rq->idle) {
+        /* Idle can't leave the CPU; wait for an interrupt instead, without
+         * the lock that interrupt's wakeup will need */
+        meow_spin_unlock(&rq->lock);
+        HAL_CPU_OP_SAFE(enter_sleep, MEOW_ERROR_NOT_SUPPORTED, 0);
+        meow_irq_restore(flags);
+        return;
+    }
+
+    current->state = MEOW_THREAD_BLOCKED;
+    schedule_internal(0);
+    rq_unlock_internal(rq, flags);
+}
+
+/* Wake @thread, first setting @flag under its queue lock if given */
+static void thread_wake_internal(meow_thread_t* thread, volatile uint8_t* flag) {
+    uint32_t cpu = thread->cpu;
+    meow_runqueue_t* rq = &run_queues[cpu];
+    uint8_t kick = 0;
+    uint32_t flags = rq_lock_internal(rq);
+    if (flag) {
+        *flag = 1;
+    }
+    if (thread->state == MEOW_THREAD_BLOCKED) {
+        rq_wake_internal(rq, thread);
+        kick = rq->need_resched;
+    } else if (!flag && thread->state != MEOW_THREAD_DEAD) {
+        /* Not asleep yet: its next meow_thread_block returns at once */
+        thread->wake_pending = 1;
+    }
+    /* Once unlocked @thread may see @flag, exit and be freed */
+    rq_unlock_internal(rq, flags);
+    if (kick) {
+        rq_kick_internal(cpu);
+    }
+}
+
+void meow_thread_wake(meow_thread_t* thread) {
+    if (!thread) {
+        return;
+    }
+    thread_wake_internal(thread, NULL);
+}
+
+void meow_thread_wait(volatile uint8_t* flag) {
+    meow_runqueue_t* rq = this_rq_internal();
+    if (!threads_initialized || !rq) {
+        return;
+    }
+
+    /* The flag is set under this lock, so testing it here can't miss it */
+    uint32_t flags = rq_lock_internal(rq);
+    while (!*flag) {
+        meow_thread_t* current = rq->current;
+        if (current == rq->idle) {
+            meow_spin_unlock(&rq->lock);
+            HAL_CPU_OP_SAFE(enter_sleep, MEOW_ERROR_NOT_SUPPORTED, 0);
+            (void)rq_lock_internal(rq);
+            continue;
+        }
+        current->state = MEOW_THREAD_BLOCKED;
+        schedule_internal(0);
+    }
+    /* Any plain wakeup that arrived meanwhile is spent too */
+    rq->current->wake_pending = 0;
+    rq_unlock_internal(rq, flags);
+}
+
+void meow_thread_signal(meow_thread_t* thread, volatile uint8_t* flag) {
+    if (!thread) {
+        *flag = 1;
+        return;
+    }
+    thread_wake_internal(thread, flag);
+}
+
+void meow_thread_exit(void) {
+    /* Never released here: the next thread does that */
+    meow_runqueue_t* rq = this_rq_internal();
+    (void)rq_lock_internal(rq);
+
+    meow_thread_t* self = rq->current;
+    self->state = MEOW_THREAD_DEAD;
+    meow_spin_lock(&threads_lock);
+    self->next = zombie_threads;
+    zombie_threads = self;
+    meow_spin_unlock(&threads_lock);
+
+    schedule_internal(0);
+    for (;;) {
+        /* A dead thread is never switched back to */
+    }
+}
+
+meow_thread_t* meow_thread_current(void) {
+    meow_runqueue_t* rq = this_rq_internal();
+    return rq ? rq->current : NULL;
+}
+
+/* One %fs-relative add each on x86, so an interrupt never sees half an
+ * update; a thread can't change CPUs while its count is raised */
+void meow_thread_preempt_disable(void) {
+    this_cpu_inc(preempt_count);
+}
+
+void meow_thread_preempt_enable(void) {
+    if (this_cpu_read(preempt_count)) {
+        this_cpu_add(preempt_count, -1);
+    }
+}
+
+meow_error_t meow_sched_get_stats(uint32_t cpu, meow_sched_stats_t* stats) {
+    if (!stats) {
+        return MEOW_ERROR_NULL_POINTER;
+    }
+    if (cpu >= MEOW_SCHED_MAX_CPUS) {
+        return MEOW_ERROR_INVALID_PARAMETER;
+    }
+
+    meow_runqueue_t* rq = &run_queues[cpu];
+    uint32_t flags = rq_lock_internal(rq);
+    *stats = rq->stats;
+    rq_unlock_internal(rq, flags);
+    return MEOW_SUCCESS;
+}
+
+void meow_thread_print_stats(void) {
+    static const char* state_names[] = { "ready", "running", "blocked", "dead" };
+
+    for (uint32_t cpu = 0; cpu < MEOW_SCHED_MAX_CPUS; cpu++) {
+        meow_sched_stats_t stats;
+        if (!run_queues[cpu].online || meow_sched_get_stats(cpu, &stats) != MEOW_SUCCESS) {
+            continue;
+        }
+        meow_printf("CPU %u kittens (%u switches, %u preempted, %u ms idle, %u ready)\n",
+                    cpu, (uint32_t)stats.context_switches, (uint32_t)stats.preemptions,
+                    (uint32_t)(stats.idle_ns / 1000000), stats.nr_ready);
+    }
+
+    /* States may move on while printing; this is only a snapshot */
+    uint32_t flags = meow_spin_lock_irqsave(&threads_lock);
+    for (meow_thread_t* thread = all_threads; thread; thread = thread->all_next) {
+        meow_printf("  #%u %s: %s on CPU %u, prio %u, %u ms, in %u, yielded %u, preempted %u\n",
+                    thread->id, thread->name, state_names[thread->state], thread->cpu,
+                    thread->priority, (uint32_t)(thread->runtime_ns / 1000000),
+                    (uint32_t)thread->switches_in, (uint32_t)thread->voluntary_switches,
+                    (uint32_t)thread->preemptions);
+    }
+    meow_spin_unlock_irqrestore(&threads_lock, flags);
+}
@@ -0,0 +1,199 @@
+/* kernel/meow_thread.h - MeowKernel Kernel Threads Interface
+ *
+ * Preemptive kernel threads ("kittens"). Each has a control block from a
+ * dedicated object cache and a stack from the physical memory manager.
+ * Every CPU has its own run queue and lock: a FIFO per priority plus a
+ * bitmap of the non-empty ones, so picking the next thread is a single
+ * bit scan. A thread is placed on the least loaded CPU when it is created
+ * and stays there, and every CPU in the scheduler has its own idle thread.
+ * Each CPU's timer tick hands out its time slices and an interrupt exit
+ * hook preempts the running thread when its slice is used up or a higher
+ * priority thread becomes ready; a reschedule IPI makes a thread readied
+ * from another CPU take effect at once.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#ifndef MEOW_THREAD_H
+#define MEOW_THREAD_H
+
+#include <stdint.h>
+#include "meow_error_definitions.h"
+
+/* ============================================================================
+ * THREAD CONSTANTS
+ * ============================================================================ */
+
+#define MEOW_THREAD_NAME_LENGTH     16          /* Including terminating NUL */
+#define MEOW_THREAD_STACK_ORDER     1           /* 2 territories, 8KB */
+#define MEOW_THREAD_SLICE_TICKS     2           /* Ticks before preemption */
+#define MEOW_THREAD_PRIORITIES      32          /* One bit each in the run queue bitmap */
+#define MEOW_THREAD_PRIORITY_HIGH   0
+#define MEOW_THREAD_PRIORITY_NORMAL 16
+#define MEOW_THREAD_PRIORITY_LOW    (MEOW_THREAD_PRIORITIES - 1)
+#define MEOW_SCHED_MAX_CPUS         16
+
+/* ============================================================================
+ * THREAD DATA STRUCTURES
+ * ============================================================================ */
+
+typedef void (*meow_thread_fn_t)(void* arg);
+
+typedef enum meow_thread_state {
+    MEOW_THREAD_READY = 0,                      /* On a run queue */
+    MEOW_THREAD_RUNNING,
+    MEOW_THREAD_BLOCKED,                        /* Waiting for meow_thread_wake */
+    MEOW_THREAD_DEAD                            /* Exited, waiting to be reaped */
+} meow_thread_state_t;
+
+/**
+ * meow_thread - Thread control block
+ *
+ * The saved stack pointer is all the context a switched-out thread has;
+ * its registers are on its own stack.
+ */
+typedef struct meow_thread {
+    void* saved_sp;                     /* Valid while not running */
+    struct meow_thread* next;           /* Run queue or zombie list link */
+    struct meow_thread* all_next;       /* List of every thread */
+    meow_thread_state_t state;
+    uint8_t wake_pending;               /* Woken while not yet blocked */
+    uint32_t id;
+    uint32_t priority;                  /* 0 is the most urgent */
+    uint32_t cpu;                       /* Run queue it belongs to, fixed at creation */
+    uint32_t stack_base;                /* 0 on the boot and AP stacks */
+    meow_thread_fn_t entry;
+    void* arg;
+    uint64_t runtime_ns;                /* CPU time, up to the last switch out */
+    uint64_t switches_in;               /* Times it was scheduled */
+    uint64_t voluntary_switches;        /* Yielded, blocked or exited */
+    uint64_t preemptions;               /* Switched out by the scheduler */
+    char name[MEOW_THREAD_NAME_LENGTH];
+} meow_thread_t;
+
+/**
+ * meow_sched_stats - Per-CPU scheduler counters
+ */
+typedef struct meow_sched_stats {
+    uint64_t context_switches;
+    uint64_t preemptions;               /* Switches forced from interrupt exit */
+    uint64_t idle_ns;                   /* Time spent in the idle thread */
+    uint32_t nr_ready;                  /* Threads waiting on the run queue */
+} meow_sched_stats_t;
+
+/* ============================================================================
+ * THREAD INTERFACE
+ * ============================================================================ */
+
+/**
+ * meow_thread_subsystem_init - Turn the boot flow into the first thread
+ *
+ * Also creates CPU 0's idle thread and hooks preemption into the timer
+ * tick and the interrupt exit path. Needs the tick and the memory managers.
+ */
+meow_error_t meow_thread_subsystem_init(void);
+
+/**
+ * meow_thread_start_cpu - Join the scheduler from a secondary CPU
+ *
+ * Waits for meow_thread_subsystem_init, turns the caller into this CPU's
+ * idle thread, enables interrupts and runs the idle loop. New threads may
+ * be placed on this CPU from then on. The CPU's tick must be started
+ * first, or its threads only switch when they block or yield.
+ */
+void meow_thread_start_cpu(void) __attribute__((noreturn));
+
+/**
+ * meow_thread_create - Start a new kernel thread
+ * @name: Name for diagnostics, truncated to fit
+ * @entry: Thread function; returning from it exits the thread
+ * @arg: Passed to @entry
+ *
+ * The thread is made ready immediately at MEOW_THREAD_PRIORITY_NORMAL, on
+ * the least loaded CPU. Returns NULL when out of memory.
+ */
+meow_thread_t* meow_thread_create(const char* name, meow_thread_fn_t entry, void* arg);
+
+/**
+ * meow_thread_set_priority - Change a thread's priority
+ * @thread: Thread to change
+ * @priority: New priority, below MEOW_THREAD_PRIORITIES
+ *
+ * Takes effect at once; raising a ready thread above the running one
+ * preempts it at the next interrupt exit.
+ */
+meow_error_t meow_thread_set_priority(meow_thread_t* thread, uint32_t priority);
+
+/**
+ * meow_yield - Give the CPU to the next ready thread of equal or higher
+ * priority, if there is one
+ */
+void meow_yield(void);
+
+/**
+ * meow_thread_block - Sleep until another context calls meow_thread_wake
+ *
+ * To avoid a lost wakeup, disable interrupts, test the wait condition and
+ * call this in a loop; the caller's interrupt state is restored on return.
+ * A wakeup from another CPU that lands between the test and the call
+ * makes this return at once.
+ */
+void meow_thread_block(void);
+
+/**
+ * meow_thread_wake - Make a blocked thread ready again
+ * @thread: Thread to wake; if it isn't blocked yet, its next
+ *          meow_thread_block returns straight away
+ */
+void meow_thread_wake(meow_thread_t* thread);
+
+/**
+ * meow_thread_wait - Sleep until another context sets @flag
+ * @flag: Set by meow_thread_signal; nonzero on return
+ *
+ * Unlike a meow_thread_block loop, the caller may free whatever holds
+ * @flag as soon as this returns. Wakeups from meow_thread_wake that
+ * arrive while waiting are discarded.
+ */
+void meow_thread_wait(volatile uint8_t* flag);
+
+/**
+ * meow_thread_signal - Set @flag and wake the thread waiting on it
+ * @thread: Thread in meow_thread_wait, or NULL to only set @flag
+ * @flag: Flag it waits on
+ *
+ * Neither @thread nor @flag is touched once the waiter can see the flag.
+ */
+void meow_thread_signal(meow_thread_t* thread, volatile uint8_t* flag);
+
+/**
+ * meow_thread_exit - End the calling thread
+ */
+void meow_thread_exit(void) __attribute__((noreturn));
+
+/**
+ * meow_thread_current - The running thread, NULL before init
+ */
+meow_thread_t* meow_thread_current(void);
+
+/**
+ * meow_thread_preempt_disable / meow_thread_preempt_enable - Nestable
+ * sections in which the interrupt exit hook will not switch threads
+ */
+void meow_thread_preempt_disable(void);
+void meow_thread_preempt_enable(void);
+
+/**
+ * meow_sched_get_stats - Copy out one CPU's scheduler counters
+ * @cpu: CPU index
+ * @stats: Where to store them
+ */
+meow_error_t meow_sched_get_stats(uint32_t cpu, meow_sched_stats_t* stats);
+
+/**
+ * meow_thread_print_stats - Print the thread list with runtimes and
+ * switch counts
+ */
+void meow_thread_print_stats(void);
+
+#endif /* MEOW_THREAD_H */
@@ -0,0 +1,187 @@
+/* kernel/meow_tick.c - MeowKernel Tick and Idle
+ *
+ * Dynamic tick for the idle loop. While busy the HAL timer ticks
+ * periodically; on idle entry the tick is replaced by a single one-shot
+ * interrupt at the earliest requested deadline, and restored on exit.
+ *
+ * CPU 0's timer is the system tick: it runs the global handlers and is
+ * the only one that goes one-shot. Every CPU's tick runs the per-CPU
+ * handlers, so the other CPUs keep theirs running while idle.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "meow_tick.h"
+#include "meow_util.h"
+#include "meow_lock.h"
+#include "meow_percpu.h"
+#include "../advanced/hal/meow_hal_interface.h"
+
+/* Global tick state */
+static meow_tick_handler_t tick_handlers[MEOW_TICK_MAX_HANDLERS];
+static uint32_t tick_handler_count = 0;
+static meow_tick_handler_t cpu_tick_handlers[MEOW_TICK_MAX_HANDLERS];
+static uint32_t cpu_tick_handler_count = 0;
+static uint64_t next_deadline = MEOW_TICK_NO_DEADLINE;
+static volatile uint8_t tick_idle = 0;     /* CPU 0 is asleep on a one-shot */
+static meow_tick_stats_t tick_stats;
+static uint8_t tick_initialized = 0;
+
+/* The deadline and CPU 0's idle state, which other CPUs request against */
+MEOW_LOCK_CLASS(tick_lock_class, "tick");
+static meow_spinlock_t tick_lock = MEOW_SPINLOCK_INIT(&tick_lock_class);
+
+/* ============================================================================
+ * INTERNAL HELPERS
+ * ============================================================================ */
+
+/* Timer interrupt: on CPU 0 consume a passed deadline and run the global
+ * handlers, then run the per-CPU ones */
+static void tick_interrupt_internal(void) {
+    uint64_t now = meow_tick_now_ns();
+
+    if (meow_this_cpu() == 0) {
+        meow_spin_lock(&tick_lock);
+        tick_stats.ticks++;
+        if (now >= next_deadline) {
+            next_deadline = MEOW_TICK_NO_DEADLINE;
+            if (tick_idle) {
+                tick_stats.deadline_wakeups++;
+            }
+        }
+        meow_spin_unlock(&tick_lock);
+
+        for (uint32_t i = 0; i < tick_handler_count; i++) {
+            tick_handlers[i](now);
+        }
+    }
+
+    for (uint32_t i = 0; i < cpu_tick_handler_count; i++) {
+        cpu_tick_handlers[i](now);
+    }
+}
+
+static meow_error_t register_internal(meow_tick_handler_t* handlers, uint32_t* count,
+                                      meow_tick_handler_t handler) {
+    if (!handler) {
+        return MEOW_ERROR_NULL_POINTER;
+    }
+    if (*count >= MEOW_TICK_MAX_HANDLERS) {
+        return MEOW_ERROR_RESOURCE_EXHAUSTED;
+    }
+
+    handlers[(*count)++] = handler;
+    return MEOW_SUCCESS;
+}
+
+static void sleep_internal(void) {
+    HAL_CPU_OP_SAFE(enter_sleep, MEOW_ERROR_NOT_SUPPORTED, 0);
+}
+
+/* ============================================================================
+ * TICK INTERFACE
+ * ============================================================================ */
+
+meow_error_t meow_tick_init(void) {
+    if (tick_initialized) {
+        return MEOW_ERROR_ALREADY_INITIALIZED;
+    }
+
+    const hal_ops_t* ops = hal_get_ops();
+    if (!ops || !ops->timer_ops) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+
+    MEOW_RETURN_IF_ERROR(HAL_TIMER_OP_SAFE(register_callback, MEOW_ERROR_NOT_SUPPORTED,
+                                           tick_interrupt_internal));
+
+    meow_memset(&tick_stats, 0, sizeof(tick_stats));
+    tick_stats.tickless = HAL_VALIDATE_OP(ops->timer_ops, set_oneshot) &&
+                          HAL_VALIDATE_OP(ops->timer_ops, set_periodic);
+    tick_initialized = 1;
+
+    meow_log(MEOW_LOG_CHIRP, "Tick: %s idle", tick_stats.tickless ? "tickless" : "periodic");
+    return MEOW_SUCCESS;
+}
+
+meow_error_t meow_tick_register_handler(meow_tick_handler_t handler) {
+    return register_internal(tick_handlers, &tick_handler_count, handler);
+}
+
+meow_error_t meow_tick_register_cpu_handler(meow_tick_handler_t handler) {
+    return register_internal(cpu_tick_handlers, &cpu_tick_handler_count, handler);
+}
+
+void meow_tick_request_deadline(uint64_t deadline_ns) {
+    uint8_t kick = 0;
+
+    /* 64-bit store, keep the timer interrupt from seeing half of it */
+    uint32_t flags = meow_spin_lock_irqsave(&tick_lock);
+    if (deadline_ns < next_deadline) {
+        next_deadline = deadline_ns;
+        /* CPU 0 may be asleep on a later one-shot; waking it re-arms */
+        kick = tick_idle && meow_this_cpu() != 0;
+    }
+    meow_spin_unlock_irqrestore(&tick_lock, flags);
+
+    if (kick) {
+        HAL_CPU_OP_SAFE(send_reschedule, MEOW_ERROR_NOT_SUPPORTED, 0);
+    }
+}
+
+void meow_tick_idle(void) {
+    /* Other CPUs keep their tick; it drives their time slices */
+    if (!tick_initialized || !tick_stats.tickless || meow_this_cpu() != 0) {
+        sleep_internal();
+        return;
+    }
+
+    HAL_CPU_OP_SAFE(disable_interrupts, MEOW_ERROR_NOT_SUPPORTED);
+
+    /* The HAL clamps long sleeps to what the hardware can count; an early
+     * wakeup just comes back here and re-arms. tick_idle is set under the
+     * lock so a deadline requested after the read sends a wakeup. */
+    meow_spin_lock(&tick_lock);
+    uint64_t now = meow_tick_now_ns();
+    uint64_t delta = MEOW_TICK_NO_DEADLINE;
+    if (next_deadline != MEOW_TICK_NO_DEADLINE) {
+        delta = next_deadline > now ? next_deadline - now : 0;
+    }
+
+    if (HAL_TIMER_OP_SAFE(set_oneshot, MEOW_ERROR_NOT_SUPPORTED, delta) != MEOW_SUCCESS) {
+        meow_spin_unlock(&tick_lock);
+        sleep_internal();
+        return;
+    }
+
+    tick_stats.idle_entries++;
+    tick_idle = 1;
+    meow_spin_unlock(&tick_lock);
+    sleep_internal();              /* Returns once the wakeup interrupt has run */
+
+    HAL_CPU_OP_SAFE(disable_interrupts, MEOW_ERROR_NOT_SUPPORTED);
+    meow_tick_idle_exit();
+    HAL_CPU_OP_SAFE(enable_interrupts, MEOW_ERROR_NOT_SUPPORTED);
+}
+
+void meow_tick_idle_exit(void) {
+    if (meow_this_cpu() == 0 && tick_idle) {
+        tick_idle = 0;
+        HAL_TIMER_OP_SAFE(set_periodic, MEOW_ERROR_NOT_SUPPORTED);
+    }
+}
+
+uint64_t meow_tick_now_ns(void) {
+    return HAL_TIMER_OP_SAFE(get_ns, 0);
+}
+
+meow_error_t meow_tick_get_stats(meow_tick_stats_t* stats) {
+    if (!stats) {
+        return MEOW_ERROR_NULL_POINTER;
+    }
+
+    uint32_t flags = meow_spin_lock_irqsave(&tick_lock);
+    *stats = tick_stats;
+    meow_spin_unlock_irqrestore(&tick_lock, flags);
+    return MEOW_SUCCESS;
+}
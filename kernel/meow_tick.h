@@ -0,0 +1,109 @@
+/* kernel/meow_tick.h - MeowKernel Tick and Idle Interface
+ *
+ * The periodic tick runs while the kernel is busy. When it goes idle the
+ * tick is stopped and the timer is programmed once for the nearest
+ * requested deadline, so an idle system only wakes up when it has to.
+ * Only CPU 0 does that; it keeps the system tick. The other CPUs tick
+ * for their own per-CPU handlers and keep ticking while idle.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#ifndef MEOW_TICK_H
+#define MEOW_TICK_H
+
+#include <stdint.h>
+#include "meow_error_definitions.h"
+
+/* ============================================================================
+ * TICK CONSTANTS
+ * ============================================================================ */
+
+#define MEOW_TICK_MAX_HANDLERS      4
+#define MEOW_TICK_NO_DEADLINE       0xFFFFFFFFFFFFFFFFULL
+
+/* ============================================================================
+ * TICK DATA STRUCTURES
+ * ============================================================================ */
+
+/**
+ * meow_tick_handler_t - Called from the timer interrupt
+ * @now_ns: Current time in nanoseconds since boot
+ *
+ * Runs on every periodic tick and on every idle wakeup from the one-shot
+ * timer. A handler that still has work pending re-requests its deadline.
+ */
+typedef void (*meow_tick_handler_t)(uint64_t now_ns);
+
+/**
+ * meow_tick_stats - Tick and idle counters
+ */
+typedef struct meow_tick_stats {
+    uint64_t ticks;                     /* System ticks taken on CPU 0 */
+    uint64_t idle_entries;              /* Times the tick was stopped */
+    uint64_t deadline_wakeups;          /* Idle periods ended by a deadline */
+    uint8_t tickless;                   /* One-shot idle mode is active */
+} meow_tick_stats_t;
+
+/* ============================================================================
+ * TICK INTERFACE
+ * ============================================================================ */
+
+/**
+ * meow_tick_init - Hook the timer interrupt and detect one-shot support
+ *
+ * Without HAL one-shot support the tick keeps running while idle.
+ */
+meow_error_t meow_tick_init(void);
+
+/**
+ * meow_tick_register_handler - Run a function on every system tick
+ * @handler: Function to call, on CPU 0
+ */
+meow_error_t meow_tick_register_handler(meow_tick_handler_t handler);
+
+/**
+ * meow_tick_register_cpu_handler - Run a function on every CPU's tick
+ * @handler: Function to call, on whichever CPU took the interrupt
+ */
+meow_error_t meow_tick_register_cpu_handler(meow_tick_handler_t handler);
+
+/**
+ * meow_tick_request_deadline - Wake an idle CPU no later than @deadline_ns
+ * @deadline_ns: Absolute time in nanoseconds since boot
+ *
+ * Only the earliest outstanding request is kept. It is consumed once it
+ * passes, after which the handlers run and may request the next one.
+ * Callable from any CPU; CPU 0 is woken if it is asleep past it.
+ */
+void meow_tick_request_deadline(uint64_t deadline_ns);
+
+/**
+ * meow_tick_idle - Sleep until the next deadline or interrupt
+ *
+ * Stops the periodic tick, programs the one-shot timer, halts, and
+ * restarts the tick on the way out. On other CPUs it only halts. Call
+ * with interrupts enabled.
+ */
+void meow_tick_idle(void);
+
+/**
+ * meow_tick_idle_exit - Restart the periodic tick after idle
+ *
+ * For a scheduler leaving the idle loop from an interrupt, before the
+ * idle code gets to do it. Call with interrupts disabled.
+ */
+void meow_tick_idle_exit(void);
+
+/**
+ * meow_tick_now_ns - Nanoseconds since boot from the HAL clocksource
+ */
+uint64_t meow_tick_now_ns(void);
+
+/**
+ * meow_tick_get_stats - Copy out the tick counters
+ * @stats: Where to store them
+ */
+meow_error_t meow_tick_get_stats(meow_tick_stats_t* stats);
+
+#endif /* MEOW_TICK_H */
@@ -0,0 +1,320 @@
+/* kernel/meow_timer.c - MeowKernel Timer Wheel
+ *
+ * Classic cascading timing wheel. The root wheel has one slot per
+ * millisecond for the next 256 ms; each outer wheel has 64 slots, each
+ * 64 times coarser than the one below. A timer goes straight into the
+ * slot for its expiry, so add and cancel are O(1). Whenever the root
+ * wheel wraps, the next slot of the outer wheels is redistributed one
+ * level down, which keeps expiry exact to the millisecond.
+ *
+ * The wheel is driven from the tick handler and asks the tick code for
+ * a wakeup at the next expiry so idle CPUs sleep until then.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "meow_timer.h"
+#include "meow_tick.h"
+#include "meow_thread.h"
+#include "meow_util.h"
+#include "meow_lock.h"
+
+#define ROOT_MASK           (MEOW_TIMER_ROOT_SIZE - 1)
+#define LEVEL_MASK          (MEOW_TIMER_LEVEL_SIZE - 1)
+#define LEVEL_SHIFT(level)  (MEOW_TIMER_ROOT_BITS + (level) * MEOW_TIMER_LEVEL_BITS)
+#define NS_PER_MS           1000000ULL
+
+/* Global wheel state */
+static meow_timer_link_t wheel_root[MEOW_TIMER_ROOT_SIZE];
+static meow_timer_link_t wheel_levels[MEOW_TIMER_LEVELS][MEOW_TIMER_LEVEL_SIZE];
+static uint64_t wheel_clock = 0;        /* Next millisecond to process */
+static uint32_t wheel_pending = 0;
+static uint8_t wheel_initialized = 0;
+
+/* The wheel is shared with the timer interrupt */
+MEOW_LOCK_CLASS(wheel_lock_class, "timer-wheel");
+static meow_spinlock_t wheel_lock = MEOW_SPINLOCK_INIT(&wheel_lock_class);
+
+/* ============================================================================
+ * INTERNAL HELPERS
+ * ============================================================================ */
+
+static inline uint32_t wheel_lock_internal(void) {
+    return meow_spin_lock_irqsave(&wheel_lock);
+}
+
+static inline void wheel_unlock_internal(uint32_t flags) {
+    meow_spin_unlock_irqrestore(&wheel_lock, flags);
+}
+
+static inline void link_init_internal(meow_timer_link_t* head) {
+    head->next = head;
+    head->prev = head;
+}
+
+static inline void link_add_tail_internal(meow_timer_link_t* head, meow_timer_link_t* link) {
+    link->next = head;
+    link->prev = head->prev;
+    head->prev->next = link;
+    head->prev = link;
+}
+
+static inline void link_del_internal(meow_timer_link_t* link) {
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->next = NULL;
+    link->prev = NULL;
+}
+
+/* Move a whole slot onto another head, leaving the slot empty */
+static inline void link_splice_internal(meow_timer_link_t* from, meow_timer_link_t* to) {
+    if (from->next == from) {
+        link_init_internal(to);
+        return;
+    }
+    to->next = from->next;
+    to->prev = from->prev;
+    to->next->prev = to;
+    to->prev->next = to;
+    link_init_internal(from);
+}
+
+/* Put a timer in the slot matching its distance from the wheel clock */
+static void wheel_insert_internal(meow_timer_t* timer) {
+    uint64_t expires = timer->expires;
+    meow_timer_link_t* slot;
+
+    if (expires < wheel_clock) {
+        /* Already due: run on the next slot processed */
+        slot = &wheel_root[wheel_clock & ROOT_MASK];
+    } else {
+        uint64_t delta = expires - wheel_clock;
+        if (delta > MEOW_TIMER_MAX_DELTA) {
+            delta = MEOW_TIMER_MAX_DELTA;
+            expires = wheel_clock + delta;
+        }
+
+        if (delta < MEOW_TIMER_ROOT_SIZE) {
+            slot = &wheel_root[expires & ROOT_MASK];
+        } else {
+            uint32_t level = 0;
+            while (level < MEOW_TIMER_LEVELS - 1 && delta >= (1ULL << LEVEL_SHIFT(level + 1))) {
+                level++;
+            }
+            slot = &wheel_levels[level][(expires >> LEVEL_SHIFT(level)) & LEVEL_MASK];
+        }
+    }
+
+    link_add_tail_internal(slot, &timer->link);
+}
+
+/* Redistribute one outer slot; returns its index so the caller knows
+ * whether the next level wrapped too */
+static uint32_t wheel_cascade_internal(uint32_t level, uint32_t index) {
+    meow_timer_link_t work;
+
+    link_splice_internal(&wheel_levels[level][index], &work);
+    while (work.next != &work) {
+        meow_timer_t* timer = (meow_timer_t*)work.next;
+        link_del_internal(&timer->link);
+        wheel_insert_internal(timer);
+    }
+    return index;
+}
+
+/* Run every timer that expired up to and including now_ms. Called with
+ * the wheel lock held; it is dropped around each handler. */
+static void wheel_run_internal(uint64_t now_ms) {
+    if (wheel_pending == 0) {
+        /* Nothing to cascade or run, just catch up */
+        if (wheel_clock <= now_ms) {
+            wheel_clock = now_ms + 1;
+        }
+        return;
+    }
+
+    while (wheel_clock <= now_ms) {
+        uint32_t index = wheel_clock & ROOT_MASK;
+        if (index == 0) {
+            for (uint32_t level = 0; level < MEOW_TIMER_LEVELS; level++) {
+                uint32_t slot = (wheel_clock >> LEVEL_SHIFT(level)) & LEVEL_MASK;
+                if (wheel_cascade_internal(level, slot) != 0) {
+                    break;
+                }
+            }
+        }
+
+        meow_timer_link_t work;
+        link_splice_internal(&wheel_root[index], &work);
+        wheel_clock++;
+
+        /* One at a time: a handler may cancel a timer still on the list */
+        while (work.next != &work) {
+            meow_timer_t* timer = (meow_timer_t*)work.next;
+            link_del_internal(&timer->link);
+            wheel_pending--;
+            meow_spin_unlock(&wheel_lock);
+            timer->function(timer, timer->data);
+            meow_spin_lock(&wheel_lock);
+        }
+    }
+}
+
+/* Ask the tick code to wake us for the nearest expiry. Only the root
+ * wheel up to the next cascade point is searched; outer timers are not
+ * in the root wheel before that point, so waking there loses nothing. */
+static void wheel_request_deadline_internal(void) {
+    if (wheel_pending == 0) {
+        return;
+    }
+
+    uint64_t next = (wheel_clock + ROOT_MASK) & ~(uint64_t)ROOT_MASK;
+    for (uint32_t i = 0; i < MEOW_TIMER_ROOT_SIZE; i++) {
+        uint64_t clock = wheel_clock + i;
+        if (clock >= next) {
+            break;
+        }
+        if (wheel_root[clock & ROOT_MASK].next != &wheel_root[clock & ROOT_MASK]) {
+            next = clock;
+            break;
+        }
+    }
+
+    meow_tick_request_deadline(next * NS_PER_MS);
+}
+
+/* Tick handler, in timer interrupt context */
+static void wheel_tick_internal(uint64_t now_ns) {
+    uint32_t flags = wheel_lock_internal();
+    wheel_run_internal(now_ns / NS_PER_MS);
+    wheel_request_deadline_internal();
+    wheel_unlock_internal(flags);
+}
+
+/* A sleeping caller, on its own stack */
+typedef struct sleeper {
+    volatile uint8_t done;
+    meow_thread_t* thread;              /* NULL before threads exist */
+} sleeper_t;
+
+static void sleep_wakeup_internal(meow_timer_t* timer, void* data) {
+    sleeper_t* sleeper = (sleeper_t*)data;
+    meow_thread_t* thread = sleeper->thread;
+
+    (void)timer;
+    /* The sleeper may return, exit and be freed as soon as it sees done,
+     * so done is set under its queue lock and neither is touched after */
+    meow_thread_signal(thread, &sleeper->done);
+}
+
+/* ============================================================================
+ * TIMER INTERFACE
+ * ============================================================================ */
+
+meow_error_t meow_timer_subsystem_init(void) {
+    if (wheel_initialized) {
+        return MEOW_ERROR_ALREADY_INITIALIZED;
+    }
+
+    for (uint32_t i = 0; i < MEOW_TIMER_ROOT_SIZE; i++) {
+        link_init_internal(&wheel_root[i]);
+    }
+    for (uint32_t level = 0; level < MEOW_TIMER_LEVELS; level++) {
+        for (uint32_t i = 0; i < MEOW_TIMER_LEVEL_SIZE; i++) {
+            link_init_internal(&wheel_levels[level][i]);
+        }
+    }
+    wheel_clock = meow_timer_now_ms();
+    wheel_pending = 0;
+
+    MEOW_RETURN_IF_ERROR(meow_tick_register_handler(wheel_tick_internal));
+    wheel_initialized = 1;
+
+    meow_log(MEOW_LOG_CHIRP, "Timer wheel ready: %u + %ux%u slots",
+             MEOW_TIMER_ROOT_SIZE, MEOW_TIMER_LEVELS, MEOW_TIMER_LEVEL_SIZE);
+    return MEOW_SUCCESS;
+}
+
+void meow_timer_setup(meow_timer_t* timer, meow_timer_fn_t function, void* data) {
+    timer->link.next = NULL;
+    timer->link.prev = NULL;
+    timer->expires = 0;
+    timer->function = function;
+    timer->data = data;
+}
+
+meow_error_t meow_timer_add(meow_timer_t* timer, uint64_t expires) {
+    if (!timer || !timer->function) {
+        return MEOW_ERROR_NULL_POINTER;
+    }
+    if (!wheel_initialized) {
+        return MEOW_ERROR_NOT_INITIALIZED;
+    }
+    if (meow_timer_pending(timer)) {
+        return MEOW_ERROR_INVALID_STATE;
+    }
+
+    uint32_t flags = wheel_lock_internal();
+    timer->expires = expires;
+    wheel_insert_internal(timer);
+    wheel_pending++;
+    meow_tick_request_deadline((expires < wheel_clock ? wheel_clock : expires) * NS_PER_MS);
+    wheel_unlock_internal(flags);
+    return MEOW_SUCCESS;
+}
+
+uint8_t meow_timer_mod(meow_timer_t* timer, uint64_t expires) {
+    if (!timer || !timer->function || !wheel_initialized) {
+        return 0;
+    }
+
+    uint32_t flags = wheel_lock_internal();
+    uint8_t was_pending = meow_timer_pending(timer);
+    if (was_pending) {
+        link_del_internal(&timer->link);
+    } else {
+        wheel_pending++;
+    }
+    timer->expires = expires;
+    wheel_insert_internal(timer);
+    meow_tick_request_deadline((expires < wheel_clock ? wheel_clock : expires) * NS_PER_MS);
+    wheel_unlock_internal(flags);
+    return was_pending;
+}
+
+uint8_t meow_timer_del(meow_timer_t* timer) {
+    if (!timer) {
+        return 0;
+    }
+
+    uint32_t flags = wheel_lock_internal();
+    uint8_t was_pending = meow_timer_pending(timer);
+    if (was_pending) {
+        link_del_internal(&timer->link);
+        wheel_pending--;
+    }
+    wheel_unlock_internal(flags);
+    return was_pending;
+}
+
+uint64_t meow_timer_now_ms(void) {
+    return meow_tick_now_ns() / NS_PER_MS;
+}
+
+meow_error_t meow_sleep(uint32_t milliseconds) {
+    sleeper_t sleeper = { 0, meow_thread_current() };
+    meow_timer_t timer;
+
+    meow_timer_setup(&timer, sleep_wakeup_internal, &sleeper);
+    /* +1: the current millisecond is already partly gone */
+    MEOW_RETURN_IF_ERROR(meow_timer_add(&timer, meow_timer_now_ms() + milliseconds + 1));
+
+    if (sleeper.thread) {
+        meow_thread_wait(&sleeper.done);
+    }
+    /* Before threads exist, or on a CPU without a run queue */
+    while (!sleeper.done) {
+        meow_tick_idle();
+    }
+    return MEOW_SUCCESS;
+}
@@ -0,0 +1,127 @@
+/* kernel/meow_timer.h - MeowKernel Timer Wheel Interface
+ *
+ * Kernel timers on a hierarchical timing wheel with millisecond
+ * resolution. Adding and cancelling a timer is O(1); timers far in the
+ * future cascade down to finer wheels as their expiry approaches.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#ifndef MEOW_TIMER_H
+#define MEOW_TIMER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "meow_error_definitions.h"
+
+/* ============================================================================
+ * TIMER WHEEL CONSTANTS
+ * ============================================================================ */
+
+#define MEOW_TIMER_ROOT_BITS        8       /* 256 one-millisecond slots */
+#define MEOW_TIMER_LEVEL_BITS       6       /* 64 slots per outer wheel */
+#define MEOW_TIMER_LEVELS           4       /* Outer wheels */
+#define MEOW_TIMER_ROOT_SIZE        (1 << MEOW_TIMER_ROOT_BITS)
+#define MEOW_TIMER_LEVEL_SIZE       (1 << MEOW_TIMER_LEVEL_BITS)
+#define MEOW_TIMER_MAX_DELTA        0xFFFFFFFFULL  /* About 49 days */
+
+/* ============================================================================
+ * TIMER DATA STRUCTURES
+ * ============================================================================ */
+
+struct meow_timer;
+
+/**
+ * meow_timer_fn_t - Timer expiry function
+ * @timer: The timer that expired; no longer pending, may be re-added
+ * @data: Cookie given to meow_timer_setup
+ *
+ * Runs in timer interrupt context with interrupts disabled.
+ */
+typedef void (*meow_timer_fn_t)(struct meow_timer* timer, void* data);
+
+/**
+ * meow_timer_link - Circular list link for wheel slots
+ */
+typedef struct meow_timer_link {
+    struct meow_timer_link* next;
+    struct meow_timer_link* prev;
+} meow_timer_link_t;
+
+/**
+ * meow_timer - One kernel timer
+ *
+ * Owned by the caller; the wheel only links it into a slot. The link is
+ * NULL while the timer is not pending.
+ */
+typedef struct meow_timer {
+    meow_timer_link_t link;             /* Must stay first */
+    uint64_t expires;                   /* Absolute expiry in milliseconds */
+    meow_timer_fn_t function;
+    void* data;
+} meow_timer_t;
+
+/* ============================================================================
+ * TIMER INTERFACE
+ * ============================================================================ */
+
+/**
+ * meow_timer_subsystem_init - Set up the wheel and hook it to the tick
+ */
+meow_error_t meow_timer_subsystem_init(void);
+
+/**
+ * meow_timer_setup - Prepare a timer before first use
+ * @timer: Timer to prepare
+ * @function: Called on expiry
+ * @data: Passed to @function
+ */
+void meow_timer_setup(meow_timer_t* timer, meow_timer_fn_t function, void* data);
+
+/**
+ * meow_timer_add - Arm a timer that is not pending
+ * @timer: Prepared timer
+ * @expires: Absolute expiry in milliseconds since boot
+ */
+meow_error_t meow_timer_add(meow_timer_t* timer, uint64_t expires);
+
+/**
+ * meow_timer_mod - Arm or re-arm a timer
+ * @timer: Prepared timer
+ * @expires: New absolute expiry in milliseconds since boot
+ *
+ * Returns 1 if the timer was pending, 0 otherwise.
+ */
+uint8_t meow_timer_mod(meow_timer_t* timer, uint64_t expires);
+
+/**
+ * meow_timer_del - Cancel a timer
+ * @timer: Timer to cancel
+ *
+ * Returns 1 if the timer was pending, 0 otherwise.
+ */
+uint8_t meow_timer_del(meow_timer_t* timer);
+
+/**
+ * meow_timer_pending - Whether a timer is armed
+ */
+static inline uint8_t meow_timer_pending(const meow_timer_t* timer) {
+    return timer->link.next != NULL;
+}
+
+/**
+ * meow_timer_now_ms - Wheel time, milliseconds since boot
+ */
+uint64_t meow_timer_now_ms(void);
+
+/**
+ * meow_sleep - Block the caller for at least @milliseconds
+ * @milliseconds: Time to sleep
+ *
+ * Arms a timer and blocks the calling thread until it fires. Before
+ * threads exist it idles with the tick stopped instead, so the CPU wakes
+ * up for the deadline rather than on every tick.
+ */
+meow_error_t meow_sleep(uint32_t milliseconds);
+
+#endif /* MEOW_TIMER_H */
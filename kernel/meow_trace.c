@@ -0,0 +1,150 @@
+/* kernel/meow_trace.c - MeowKernel Binary Trace Events
+ *
+ * Slots are claimed with an atomic increment of the ring head, so an
+ * interrupt (or a thread that moved CPUs) writing the same ring just
+ * takes the next slot. Each slot's state word is odd while the slot is
+ * being written; the dump skips those.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#include "meow_trace.h"
+#include "meow_percpu.h"
+#include "meow_util.h"
+#include "../advanced/hal/meow_hal_atomic.h"
+#include "../advanced/hal/meow_hal_interface.h"
+
+#define TRACE_EVENT_MASK    (MEOW_TRACE_RING_EVENTS - 1)
+#define TRACE_LINE_SIZE     128
+
+typedef struct trace_ring {
+    volatile uint32_t head;             /* Next sequence number to hand out */
+    meow_trace_event_t events[MEOW_TRACE_RING_EVENTS];
+} trace_ring_t;
+
+static MEOW_DEFINE_PER_CPU(trace_ring_t, trace_ring);
+
+volatile uint8_t meow_trace_enabled = MEOW_TRACING;
+
+/* ============================================================================
+ * RECORDING
+ * ============================================================================ */
+
+void meow_trace_record(const char* format, const uint32_t* args, uint32_t count) {
+    trace_ring_t* ring = this_cpu_ptr(&trace_ring);
+    uint32_t seq = meow_atomic_fetch_add_u32(&ring->head, 1);
+    meow_trace_event_t* event = &ring->events[seq & TRACE_EVENT_MASK];
+
+    event->state = (seq << 1) | 1;
+    meow_wmb();
+    event->format = (uint32_t)(uintptr_t)format;
+    event->timestamp = meow_trace_clock();
+    for (uint32_t i = 0; i < MEOW_TRACE_MAX_ARGS; i++) {
+        event->args[i] = i < count ? args[i] : 0;
+    }
+    meow_store_release_u32(&event->state, seq << 1);
+}
+
+uint8_t meow_trace_enable(uint8_t enable) {
+    uint8_t previous = meow_trace_enabled;
+    meow_trace_enabled = enable;
+    return previous;
+}
+
+/* ============================================================================
+ * DUMPING
+ * ============================================================================ */
+
+static void trace_append_internal(char* line, uint32_t* length, const char* str) {
+    while (*str && *length < TRACE_LINE_SIZE - 1) {
+        line[(*length)++] = *str++;
+    }
+    line[*length] = '\0';
+}
+
+static void trace_append_hex_internal(char* line, uint32_t* length, uint32_t value) {
+    static const char digits[] = "0123456789abcdef";
+    char hex[9];
+
+    for (int i = 7; i >= 0; i--) {
+        hex[7 - i] = digits[(value >> (i * 4)) & 0xF];
+    }
+    hex[8] = '\0';
+    trace_append_internal(line, length, hex);
+}
+
+static void trace_append_uint_internal(char* line, uint32_t* length, uint32_t value) {
+    char number[12];
+
+    meow_uint_to_string(value, number, 10);
+    trace_append_internal(line, length, number);
+}
+
+static void trace_emit_internal(const char* line) {
+    HAL_DEBUG_OP_SAFE(puts, MEOW_ERROR_NOT_SUPPORTED, line);
+}
+
+/*
+ * Line formats, all numbers but the CPU and header values in hex:
+ *   MEOWTRACE begin khz=<clock kHz> cpus=<count>
+ *   MEOWTRACE <cpu> <format> <timestamp, 16 digits> <arg0> <arg1> <arg2> <arg3>
+ *   MEOWTRACE end lost=<events torn or still being written>
+ */
+void meow_trace_dump(void) {
+    uint8_t was_enabled = meow_trace_enable(0);
+    uint32_t cpus = HAL_CPU_OP_SAFE(get_cpu_count, 1);
+    uint32_t lost = 0;
+    char line[TRACE_LINE_SIZE];
+    uint32_t length = 0;
+
+    if (cpus > MEOW_PERCPU_MAX_CPUS) {
+        cpus = MEOW_PERCPU_MAX_CPUS;
+    }
+
+    trace_append_internal(line, &length, "MEOWTRACE begin khz=");
+    trace_append_uint_internal(line, &length, HAL_CPU_OP_SAFE(get_cpu_frequency, 0));
+    trace_append_internal(line, &length, " cpus=");
+    trace_append_uint_internal(line, &length, cpus);
+    trace_append_internal(line, &length, "\n");
+    trace_emit_internal(line);
+
+    for (uint32_t cpu = 0; cpu < cpus; cpu++) {
+        trace_ring_t* ring = per_cpu_ptr(&trace_ring, cpu);
+        uint32_t head = meow_load_acquire_u32(&ring->head);
+        uint32_t seq = head > MEOW_TRACE_RING_EVENTS ? head - MEOW_TRACE_RING_EVENTS : 0;
+
+        for (; seq != head; seq++) {
+            meow_trace_event_t* slot = &ring->events[seq & TRACE_EVENT_MASK];
+            uint32_t state = meow_load_acquire_u32(&slot->state);
+            meow_trace_event_t event = *slot;
+            meow_rmb();
+            if (state != seq << 1 || slot->state != state) {
+                lost++;
+                continue;
+            }
+
+            length = 0;
+            trace_append_internal(line, &length, "MEOWTRACE ");
+            trace_append_uint_internal(line, &length, cpu);
+            trace_append_internal(line, &length, " ");
+            trace_append_hex_internal(line, &length, event.format);
+            trace_append_internal(line, &length, " ");
+            trace_append_hex_internal(line, &length, (uint32_t)(event.timestamp >> 32));
+            trace_append_hex_internal(line, &length, (uint32_t)event.timestamp);
+            for (uint32_t i = 0; i < MEOW_TRACE_MAX_ARGS; i++) {
+                trace_append_internal(line, &length, " ");
+                trace_append_hex_internal(line, &length, event.args[i]);
+            }
+            trace_append_internal(line, &length, "\n");
+            trace_emit_internal(line);
+        }
+    }
+
+    length = 0;
+    trace_append_internal(line, &length, "MEOWTRACE end lost=");
+    trace_append_uint_internal(line, &length, lost);
+    trace_append_internal(line, &length, "\n");
+    trace_emit_internal(line);
+
+    meow_trace_enable(was_enabled);
+}
@@ -0,0 +1,113 @@
+/* kernel/meow_trace.h - MeowKernel Binary Trace Events
+ *
+ * MEOW_TRACE("fmt", args...) records an event without formatting it: the
+ * address of the format string, a cycle counter timestamp and up to four
+ * raw 32-bit arguments go into the calling CPU's ring. The format strings
+ * live in their own .meow_trace_fmt section, so scripts/meow_trace.py can
+ * turn an event back into text using nothing but the kernel ELF.
+ *
+ * Arguments are cast to uint32_t. A %s argument must be a string in the
+ * kernel image; the decoder reads it from the ELF, not from memory.
+ *
+ * Built with TRACE=0 (MEOW_TRACING=0) the macro compiles to nothing.
+ *
+ * Copyright (c) 2025 MeowKernel Project
+ */
+
+#ifndef MEOW_TRACE_H
+#define MEOW_TRACE_H
+
+#include <stdint.h>
+
+#ifndef MEOW_TRACING
+#define MEOW_TRACING 1
+#endif
+
+/* ============================================================================
+ * TRACE CONSTANTS
+ * ============================================================================ */
+
+#define MEOW_TRACE_RING_EVENTS      256     /* Per CPU, power of two */
+#define MEOW_TRACE_MAX_ARGS         4
+
+/* ============================================================================
+ * TRACE EVENTS
+ * ============================================================================ */
+
+/**
+ * meow_trace_event - One event in a CPU's ring, 32 bytes
+ */
+typedef struct meow_trace_event {
+    volatile uint32_t state;            /* (seq << 1) | 1 while being written */
+    uint32_t format;                    /* Address of the format string */
+    uint64_t timestamp;                 /* meow_trace_clock() */
+    uint32_t args[MEOW_TRACE_MAX_ARGS];
+} meow_trace_event_t;
+
+/* Checked before recording; meow_trace_enable() flips it */
+extern volatile uint8_t meow_trace_enabled;
+
+void meow_trace_record(const char* format, const uint32_t* args, uint32_t count);
+
+#if MEOW_TRACING
+#define MEOW_TRACE(fmt, ...) do {                                               \
+    static const char meow_trace_fmt_[]                                         \
+        __attribute__((section(".meow_trace_fmt"))) = fmt;                      \
+    const uint32_t meow_trace_args_[] = { 0, ##__VA_ARGS__ };                   \
+    _Static_assert(sizeof(meow_trace_args_) <=                                  \
+                   (MEOW_TRACE_MAX_ARGS + 1) * sizeof(uint32_t),                \
+                   "MEOW_TRACE takes at most 4 arguments");                     \
+    if (meow_trace_enabled) {                                                   \
+        meow_trace_record(meow_trace_fmt_, meow_trace_args_ + 1,                \
+                          sizeof(meow_trace_args_) / sizeof(uint32_t) - 1);     \
+    }                                                                           \
+} while (0)
+#else
+#define MEOW_TRACE(fmt, ...) do {                                               \
+    if (0) {                                                                    \
+        const uint32_t meow_trace_args_[] = { 0, ##__VA_ARGS__ };               \
+        (void)meow_trace_args_;                                                 \
+    }                                                                           \
+} while (0)
+#endif
+
+/* ============================================================================
+ * TRACE CLOCK
+ * ============================================================================ */
+
+/* Raw cycle counter; meow_trace_dump() reports its rate for the decoder */
+static inline uint64_t meow_trace_clock(void) {
+#if defined(__i386__)
+    uint32_t low, high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+#elif defined(__aarch64__)
+    uint64_t count;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(count));
+    return count;
+#else
+#error "meow_trace.h: no trace clock for this architecture"
+#endif
+}
+
+/* ============================================================================
+ * TRACE INTERFACE
+ * ============================================================================ */
+
+/**
+ * meow_trace_enable - Start or stop recording
+ * @enable: 1 to record, 0 to stop
+ *
+ * @return Previous setting
+ */
+uint8_t meow_trace_enable(uint8_t enable);
+
+/**
+ * meow_trace_dump - Write every CPU's ring to the HAL debug port
+ *
+ * One "MEOWTRACE" text line per event, for scripts/meow_trace.py to pick
+ * out of a serial log. Recording is paused while dumping.
+ */
+void meow_trace_dump(void);
+
+#endif /* MEOW_TRACE_H */
@@ -5,21 +5,41 @@
  */
 
 #include "meow_util.h"
+#include "meow_dmesg.h"
+#include "meow_trace.h"
+#include "meow_lock.h"
+#include "../advanced/hal/meow_hal_interface.h"
+
+#define CONSOLE_PANIC_POLLS     1000000     /* How long a panic waits for the console */
 
 /* ============================================================================
  * GLOBAL STATE FOR VGA AND LOGGING
  * ============================================================================ */
 
-/* VGA display state */
-static uint16_t* vga_buffer = (uint16_t*)MEOW_VGA_BUFFER;
+/* VGA display state; text is drawn into the shadow and flushed to VRAM */
+static volatile uint16_t* vga_buffer = (volatile uint16_t*)MEOW_VGA_BUFFER;
+static uint16_t vga_shadow[MEOW_VGA_HEIGHT * MEOW_VGA_WIDTH];
+static uint32_t shadow_top = 0;     /* Shadow row on screen row 0 (ring of rows) */
+static uint32_t vram_top = 0;       /* VRAM row the CRTC starts the screen at */
+static uint32_t shadow_dirty = 0;   /* Bit per shadow row not yet in VRAM */
+static uint8_t dirty_from[MEOW_VGA_HEIGHT];
+static uint8_t dirty_to[MEOW_VGA_HEIGHT];
 static int cursor_x = 0;
 static int cursor_y = 0;
 static uint8_t current_fg = MEOW_VGA_LIGHT_GRAY;
 static uint8_t current_bg = MEOW_VGA_BLACK;
 
+/* Everything above: the dmesg drain, printf and the terminal_* callers
+ * draw from any thread or CPU. Taken with interrupts off. */
+MEOW_LOCK_CLASS(console_lock_class, "console");
+static meow_spinlock_t console_lock = MEOW_SPINLOCK_INIT(&console_lock_class);
+static volatile uint8_t console_panicked = 0;  /* The panic screen owns the VGA */
+
 /* Cat-themed logging state */
-static meow_log_level_t current_log_level = MEOW_LOG_CHIRP;  /* Default: show info and above */
+meow_log_level_t meow_log_current_level = MEOW_LOG_CHIRP;  /* Default: show info and above */
 static uint8_t emojis_enabled = 1;  /* Enable emojis by default */
+static meow_log_level_t vga_log_level = MEOW_LOG_PURR;       /* Screen shows all that passes */
+static uint8_t debug_port_enabled = 0;  /* Mirror output to the HAL debug port */
 
 /* ============================================================================
  * VGA HELPER FUNCTIONS
@@ -30,25 +50,139 @@ static inline uint16_t vga_entry(unsigned char uc, uint8_t fg, uint8_t bg) {
     return uc | (uint16_t)fg << 8 | (uint16_t)bg << 12;
 }
 
-/* Scroll screen up by one line */
-static void scroll_up(void) {
-    /* Move all lines up */
-    for (size_t y = 0; y < MEOW_VGA_HEIGHT - 1; y++) {
-        for (size_t x = 0; x < MEOW_VGA_WIDTH; x++) {
-            vga_buffer[y * MEOW_VGA_WIDTH + x] = 
-                vga_buffer[(y + 1) * MEOW_VGA_WIDTH + x];
-        }
+/* Shadow row holding screen row @y */
+static inline uint32_t shadow_row(uint32_t y) {
+    uint32_t row = shadow_top + y;
+    return row < MEOW_VGA_HEIGHT ? row : row - MEOW_VGA_HEIGHT;
+}
+
+static void mark_dirty(uint32_t row, uint8_t from, uint8_t to) {
+    if (!(shadow_dirty & (1u << row))) {
+        shadow_dirty |= 1u << row;
+        dirty_from[row] = from;
+        dirty_to[row] = to;
+        return;
     }
+    if (from < dirty_from[row]) dirty_from[row] = from;
+    if (to > dirty_to[row]) dirty_to[row] = to;
+}
+
+static void mark_all_dirty(void) {
+    for (uint32_t row = 0; row < MEOW_VGA_HEIGHT; row++) {
+        mark_dirty(row, 0, MEOW_VGA_WIDTH - 1);
+    }
+}
+
+/* Point the CRTC at @row of VRAM; fails until the HAL can do port I/O */
+static uint8_t vga_set_start(uint32_t row) {
+    uint16_t offset = (uint16_t)(row * MEOW_VGA_WIDTH);
+
+    if (HAL_IO_OP_SAFE(outb, MEOW_ERROR_NOT_SUPPORTED, MEOW_VGA_CRTC_INDEX,
+                       MEOW_VGA_CRTC_START_HIGH) != MEOW_SUCCESS) {
+        return 0;
+    }
+    HAL_IO_OP_SAFE(outb, MEOW_ERROR_NOT_SUPPORTED, MEOW_VGA_CRTC_DATA, (uint8_t)(offset >> 8));
+    HAL_IO_OP_SAFE(outb, MEOW_ERROR_NOT_SUPPORTED, MEOW_VGA_CRTC_INDEX, MEOW_VGA_CRTC_START_LOW);
+    HAL_IO_OP_SAFE(outb, MEOW_ERROR_NOT_SUPPORTED, MEOW_VGA_CRTC_DATA, (uint8_t)offset);
+    return 1;
+}
+
+/*
+ * Scroll screen up by one line. The shadow just rotates its rows. VRAM
+ * holds several screens, so the CRTC start moves down a row and only the
+ * new bottom line needs drawing; at the end of VRAM (or without port I/O)
+ * the screen is redrawn from row 0.
+ */
+static void scroll_up(void) {
+    uint32_t row = shadow_top;
+    uint16_t blank = vga_entry(' ', current_fg, current_bg);
 
-    /* Clear the last line */
     for (size_t x = 0; x < MEOW_VGA_WIDTH; x++) {
-        vga_buffer[(MEOW_VGA_HEIGHT - 1) * MEOW_VGA_WIDTH + x] = 
-            vga_entry(' ', current_fg, current_bg);
+        vga_shadow[row * MEOW_VGA_WIDTH + x] = blank;
+    }
+    shadow_top = shadow_row(1);
+    mark_dirty(row, 0, MEOW_VGA_WIDTH - 1);
+
+    if (vram_top + MEOW_VGA_HEIGHT < MEOW_VGA_VRAM_ROWS && vga_set_start(vram_top + 1)) {
+        vram_top++;
+    } else {
+        if (vram_top != 0) {
+            vga_set_start(0);
+            vram_top = 0;
+        }
+        mark_all_dirty();
     }
 
     cursor_y = MEOW_VGA_HEIGHT - 1;
 }
 
+/* Draw @c into the shadow without flushing it */
+static void vga_putchar_internal(char c) {
+    if (c == '\n') {
+        cursor_x = 0;
+        cursor_y++;
+    } else if (c == '\t') {
+        cursor_x = (cursor_x + 8) & ~(8 - 1);
+    } else if (c >= ' ') {
+        uint32_t row = shadow_row(cursor_y);
+        vga_shadow[row * MEOW_VGA_WIDTH + cursor_x] = vga_entry(c, current_fg, current_bg);
+        mark_dirty(row, (uint8_t)cursor_x, (uint8_t)cursor_x);
+        cursor_x++;
+    }
+
+    if (cursor_x >= MEOW_VGA_WIDTH) {
+        cursor_x = 0;
+        cursor_y++;
+    }
+
+    if (cursor_y >= MEOW_VGA_HEIGHT) {
+        scroll_up();
+    }
+}
+
+static void vga_write_internal(const char* str) {
+    while (*str) {
+        vga_putchar_internal(*str++);
+    }
+}
+
+/* Copy the dirty parts of the shadow to VRAM */
+static void vga_flush_internal(void) {
+    for (uint32_t y = 0; y < MEOW_VGA_HEIGHT && shadow_dirty; y++) {
+        uint32_t row = shadow_row(y);
+        if (!(shadow_dirty & (1u << row))) {
+            continue;
+        }
+
+        const uint16_t* src = &vga_shadow[row * MEOW_VGA_WIDTH];
+        volatile uint16_t* dest = &vga_buffer[(vram_top + y) * MEOW_VGA_WIDTH];
+        for (uint32_t x = dirty_from[row]; x <= dirty_to[row]; x++) {
+            dest[x] = src[x];
+        }
+        shadow_dirty &= ~(1u << row);
+    }
+}
+
+static void vga_clear_internal(void) {
+    uint16_t blank = vga_entry(' ', current_fg, current_bg);
+
+    for (size_t index = 0; index < MEOW_VGA_HEIGHT * MEOW_VGA_WIDTH; index++) {
+        vga_shadow[index] = blank;
+    }
+    mark_all_dirty();
+    cursor_x = 0;
+    cursor_y = 0;
+    vga_flush_internal();
+}
+
+static inline uint32_t console_lock_internal(void) {
+    return meow_spin_lock_irqsave(&console_lock);
+}
+
+static inline void console_unlock_internal(uint32_t flags) {
+    meow_spin_unlock_irqrestore(&console_lock, flags);
+}
+
 /* ============================================================================
  * CAT-THEMED LOGGING IMPLEMENTATION
  * ============================================================================ */
@@ -105,6 +239,13 @@ static uint8_t get_cat_bg_color(meow_log_level_t level) {
     }
 }
 
+/* Send a string to the HAL debug port, if it is in use */
+static void debug_port_write(const char* str) {
+    if (debug_port_enabled) {
+        HAL_DEBUG_OP_SAFE(puts, MEOW_ERROR_NOT_SUPPORTED, str);
+    }
+}
+
 /**
  * THE ONLY cat-themed logging implementation - meow_vlog
  */
@@ -118,14 +259,7 @@ static void format_number(char *buffer, int *len, const char *temp, int temp_len
 }
 
 void meow_vlog(meow_log_level_t level, const char* format, va_list args) {
-    if (level < current_log_level) return;
-
-    uint8_t saved_fg = current_fg, saved_bg = current_bg;
-    current_fg = get_cat_color(level);
-    current_bg = get_cat_bg_color(level);
-
-    terminal_writestring(get_cat_prefix(level));
-    terminal_writestring(" ");
+    if ((int)level < (int)MEOW_LOG_MIN_LEVEL || level < meow_log_current_level) return;
 
     char buffer[MEOW_UTIL_MAX_PRINTF_LEN];
     int len = 0;
@@ -216,18 +350,43 @@ void meow_vlog(meow_log_level_t level, const char* format, va_list args) {
     }
 
     buffer[len] = '\0';
-    terminal_writestring(buffer);
-    terminal_writestring("\n");
+
+    /* Drawn later by the dmesg drain, or right away early in boot */
+    meow_dmesg_log((uint8_t)level, buffer, (uint32_t)len);
+}
+
+void meow_log_render(meow_log_level_t level, const char* text) {
+    debug_port_write(get_cat_prefix(level));
+    debug_port_write(" ");
+    debug_port_write(text);
+    debug_port_write("\n");
+
+    /* The screen is slow; with a debug port it usually keeps only warnings.
+     * After a panic the log only goes to the debug port. */
+    if (level < vga_log_level || console_panicked) return;
+
+    uint32_t flags = console_lock_internal();
+    uint8_t saved_fg = current_fg, saved_bg = current_bg;
+    current_fg = get_cat_color(level);
+    current_bg = get_cat_bg_color(level);
+
+    vga_write_internal(get_cat_prefix(level));
+    vga_write_internal(" ");
+    vga_write_internal(text);
+    vga_write_internal("\n");
+    vga_flush_internal();
 
     current_fg = saved_fg;
     current_bg = saved_bg;
+    console_unlock_internal(flags);
 }
 
 /**
  * THE ONLY cat-themed logging function - meow_log
- * This is the SINGLE point of entry for ALL logging in the kernel
+ * This is the SINGLE point of entry for ALL logging in the kernel; the
+ * meow_log() macro in meow_util.h filters before calling it
  */
-void meow_log(meow_log_level_t level, const char* format, ...) {
+void (meow_log)(meow_log_level_t level, const char* format, ...) {
     va_list args;
     va_start(args, format);
     meow_vlog(level, format, args);
@@ -239,13 +398,13 @@ void meow_log(meow_log_level_t level, const char* format, ...) {
  * ============================================================================ */
 
 meow_log_level_t meow_log_set_level(meow_log_level_t level) {
-    meow_log_level_t previous = current_log_level;
-    current_log_level = level;
+    meow_log_level_t previous = meow_log_current_level;
+    meow_log_current_level = level;
     return previous;
 }
 
 meow_log_level_t meow_log_get_level(void) {
-    return current_log_level;
+    return meow_log_current_level;
 }
 
 const char* meow_log_level_to_string(meow_log_level_t level) {
@@ -267,12 +426,27 @@ uint8_t meow_log_enable_emojis(uint8_t enable) {
     return previous;
 }
 
+meow_log_level_t meow_log_set_vga_level(meow_log_level_t level) {
+    meow_log_level_t previous = vga_log_level;
+    vga_log_level = level;
+    return previous;
+}
+
+uint8_t meow_console_use_debug_port(uint8_t enable) {
+    uint8_t previous = debug_port_enabled;
+    debug_port_enabled = enable;
+    return previous;
+}
+
 /* ============================================================================
  * VGA DISPLAY FUNCTIONS
  * ============================================================================ */
 
 void meow_vga_init(void) {
-    vga_buffer = (uint16_t*)MEOW_VGA_BUFFER;
+    vga_buffer = (volatile uint16_t*)MEOW_VGA_BUFFER;
+    shadow_top = 0;
+    vram_top = 0;
+    shadow_dirty = 0;
     cursor_x = 0;
     cursor_y = 0;
     current_fg = MEOW_VGA_LIGHT_GRAY;
@@ -280,29 +454,36 @@ void meow_vga_init(void) {
 }
 
 void meow_vga_clear(void) {
-    for (size_t y = 0; y < MEOW_VGA_HEIGHT; y++) {
-        for (size_t x = 0; x < MEOW_VGA_WIDTH; x++) {
-            const size_t index = y * MEOW_VGA_WIDTH + x;
-            vga_buffer[index] = vga_entry(' ', current_fg, current_bg);
-        }
-    }
-    cursor_x = 0;
-    cursor_y = 0;
+    uint32_t flags = console_lock_internal();
+    vga_clear_internal();
+    console_unlock_internal(flags);
+}
+
+void meow_vga_flush(void) {
+    uint32_t flags = console_lock_internal();
+    vga_flush_internal();
+    console_unlock_internal(flags);
 }
 
 void meow_vga_set_color(uint8_t foreground, uint8_t background) {
+    uint32_t flags = console_lock_internal();
     current_fg = foreground;
     current_bg = background;
+    console_unlock_internal(flags);
 }
 
 void meow_vga_get_cursor(uint8_t* x, uint8_t* y) {
+    uint32_t flags = console_lock_internal();
     if (x) *x = cursor_x;
     if (y) *y = cursor_y;
+    console_unlock_internal(flags);
 }
 
 void meow_vga_set_cursor(uint8_t x, uint8_t y) {
+    uint32_t flags = console_lock_internal();
     if (x < MEOW_VGA_WIDTH) cursor_x = x;
     if (y < MEOW_VGA_HEIGHT) cursor_y = y;
+    console_unlock_internal(flags);
 }
 
 /* ============================================================================
@@ -322,31 +503,17 @@ void set_cursor_position(int x, int y) {
 }
 
 void terminal_putchar(char c) {
-    if (c == '\n') {
-        cursor_x = 0;
-        cursor_y++;
-    } else if (c == '\t') {
-        cursor_x = (cursor_x + 8) & ~(8 - 1);
-    } else if (c >= ' ') {
-        const size_t index = cursor_y * MEOW_VGA_WIDTH + cursor_x;
-        vga_buffer[index] = vga_entry(c, current_fg, current_bg);
-        cursor_x++;
-    }
-
-    if (cursor_x >= MEOW_VGA_WIDTH) {
-        cursor_x = 0;
-        cursor_y++;
-    }
-
-    if (cursor_y >= MEOW_VGA_HEIGHT) {
-        scroll_up();
-    }
+    uint32_t flags = console_lock_internal();
+    vga_putchar_internal(c);
+    vga_flush_internal();
+    console_unlock_internal(flags);
 }
 
 void terminal_writestring(const char* str) {
-    while (*str) {
-        terminal_putchar(*str++);
-    }
+    uint32_t flags = console_lock_internal();
+    vga_write_internal(str);
+    vga_flush_internal();
+    console_unlock_internal(flags);
 }
 
 void print_hex(uint32_t value) {
@@ -464,17 +631,28 @@ void meow_vprintf(const char* format, va_list args) {
     }
 
     buffer[len] = '\0';
+    debug_port_write(buffer);
     terminal_writestring(buffer);
 }
 
 void meow_puts(const char* str) {
     if (str) {
-        terminal_writestring(str);
-        terminal_writestring("\n");
+        debug_port_write(str);
+        debug_port_write("\n");
+
+        /* One line, not split by another CPU's output */
+        uint32_t flags = console_lock_internal();
+        vga_write_internal(str);
+        vga_write_internal("\n");
+        vga_flush_internal();
+        console_unlock_internal(flags);
     }
 }
 
 void meow_putc(char c) {
+    if (debug_port_enabled) {
+        HAL_DEBUG_OP_SAFE(putc, MEOW_ERROR_NOT_SUPPORTED, c);
+    }
     terminal_putchar(c);
 }
 
@@ -805,28 +983,53 @@ int meow_ltoa(long value, char* buffer, size_t buffer_size, int base) {
  * ============================================================================ */
 
 void meow_panic(const char* message) {
-    /* Save current colors */
-    uint8_t saved_fg = current_fg;
-    uint8_t saved_bg = current_bg;
-    
+    /* From here the log only reaches the debug port, so flushing what is
+     * still queued can't wait on the console lock */
+    console_panicked = 1;
+    (void)meow_irq_save();
+    meow_dmesg_flush();
+
+    /* Wait a while for whoever is drawing, then draw regardless: the
+     * holder may be this CPU or one that will never let go. The lock is
+     * kept so nothing draws over the panic. */
+    for (uint32_t polls = 0; polls < CONSOLE_PANIC_POLLS; polls++) {
+        if (meow_spin_trylock(&console_lock)) {
+            break;
+        }
+        meow_cpu_relax();
+    }
+
     /* Set panic colors (white on red) */
-    set_text_color(MEOW_VGA_WHITE, MEOW_VGA_RED);
-    clear_screen();
+    current_fg = MEOW_VGA_WHITE;
+    current_bg = MEOW_VGA_RED;
+    vga_clear_internal();
     
-    terminal_writestring("\n\n");
-    terminal_writestring("  ========== MEOWKERNEL PANIC - CATS ARE VERY UNHAPPY! ==========\n\n");
-    terminal_writestring("   CATASTROPHIC ERROR - The cats have encountered a serious problem!\n\n");
-    terminal_writestring("  Reason: ");
+    vga_write_internal("\n\n");
+    vga_write_internal("  ========== MEOWKERNEL PANIC - CATS ARE VERY UNHAPPY! ==========\n\n");
+    vga_write_internal("   CATASTROPHIC ERROR - The cats have encountered a serious problem!\n\n");
+    vga_write_internal("  Reason: ");
     if (message) {
-        terminal_writestring(message);
+        vga_write_internal(message);
     } else {
-        terminal_writestring("Unknown cat catastrophe");
+        vga_write_internal("Unknown cat catastrophe");
+    }
+    vga_write_internal("\n\n");
+    vga_write_internal("   The cats have decided to halt the system to prevent further\n");
+    vga_write_internal("     damage. Please check your code and restart the system.\n\n");
+    vga_write_internal("   System halted. Press reset to restart.\n\n");
+    vga_write_internal("  ============================================================\n");
+    vga_flush_internal();
+
+    /* The HAL flushes whatever the debug port still has queued, then halts */
+    debug_port_write("MEOWKERNEL PANIC: ");
+    debug_port_write(message ? message : "Unknown cat catastrophe");
+    debug_port_write("\n");
+    if (debug_port_enabled) {
+        meow_trace_dump();
+    }
+    if (hal_get_ops() && hal_get_ops()->emergency_halt) {
+        hal_get_ops()->emergency_halt(message);
     }
-    terminal_writestring("\n\n");
-    terminal_writestring("   The cats have decided to halt the system to prevent further\n");
-    terminal_writestring("     damage. Please check your code and restart the system.\n\n");
-    terminal_writestring("   System halted. Press reset to restart.\n\n");
-    terminal_writestring("  ============================================================\n");
     
     /* Halt the system */
     while (1) {
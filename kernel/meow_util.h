@@ -26,6 +26,13 @@
 #define MEOW_VGA_WIDTH              80
 #define MEOW_VGA_HEIGHT             25
 #define MEOW_VGA_BUFFER             0xB8000
+#define MEOW_VGA_VRAM_ROWS          204     /* 32KB window / 160-byte rows */
+
+/* VGA CRTC registers, for hardware scrolling */
+#define MEOW_VGA_CRTC_INDEX         0x3D4
+#define MEOW_VGA_CRTC_DATA          0x3D5
+#define MEOW_VGA_CRTC_START_HIGH    0x0C
+#define MEOW_VGA_CRTC_START_LOW     0x0D
 
 /* VGA color constants */
 #define MEOW_VGA_BLACK              0x0
@@ -138,6 +145,26 @@ typedef enum meow_log_level {
  */
 void meow_log(meow_log_level_t level, const char* format, ...);
 
+/*
+ * Calls below MEOW_LOG_MIN_LEVEL (LOG_LEVEL=<name> at build time) are
+ * compiled out, arguments and all. The rest check the runtime level
+ * before paying for the call and va_list setup.
+ */
+#ifndef MEOW_LOG_MIN_LEVEL
+#define MEOW_LOG_MIN_LEVEL          MEOW_LOG_PURR
+#endif
+
+/* Runtime threshold; use meow_log_set_level() to change it */
+extern meow_log_level_t meow_log_current_level;
+
+#define meow_log(level, ...) do {                                               \
+    meow_log_level_t meow_log_level_ = (level);                                 \
+    if ((int)meow_log_level_ >= (int)MEOW_LOG_MIN_LEVEL &&                      \
+        meow_log_level_ >= meow_log_current_level) {                            \
+        (meow_log)(meow_log_level_, __VA_ARGS__);                               \
+    }                                                                           \
+} while (0)
+
 /**
  * meow_vlog - Logging with va_list (internal use)
  * @level: Cat-themed log level
@@ -146,6 +173,15 @@ void meow_log(meow_log_level_t level, const char* format, ...);
  */
 void meow_vlog(meow_log_level_t level, const char* format, va_list args);
 
+/**
+ * meow_log_render - Draw one formatted message on the consoles
+ * @level: Cat-themed log level, picks prefix and colour
+ * @text: Message without prefix or newline
+ * 
+ * meow_vlog() only stores messages; the dmesg drain calls this.
+ */
+void meow_log_render(meow_log_level_t level, const char* text);
+
 /* ============================================================================
  * LOGGING CONFIGURATION
  * ============================================================================ */
@@ -154,6 +190,8 @@ void meow_vlog(meow_log_level_t level, const char* format, va_list args);
  * meow_log_set_level - Set global cat log level
  * @level: Minimum cat log level to display
  * 
+ * Levels below MEOW_LOG_MIN_LEVEL stay compiled out whatever this says.
+ * 
  * @return Previous log level
  */
 meow_log_level_t meow_log_set_level(meow_log_level_t level);
@@ -181,6 +219,25 @@ const char* meow_log_level_to_string(meow_log_level_t level);
  */
 uint8_t meow_log_enable_emojis(uint8_t enable);
 
+/**
+ * meow_log_set_vga_level - Set the lowest cat log level drawn on screen
+ * @level: Minimum level for the VGA console
+ * 
+ * The debug port, once enabled, still gets everything meow_log_set_level()
+ * lets through.
+ * 
+ * @return Previous VGA log level
+ */
+meow_log_level_t meow_log_set_vga_level(meow_log_level_t level);
+
+/**
+ * meow_console_use_debug_port - Copy log and printf output to the HAL debug port
+ * @enable: 1 once debug_ops->init() has succeeded, 0 to stop
+ * 
+ * @return Previous setting
+ */
+uint8_t meow_console_use_debug_port(uint8_t enable);
+
 /* ============================================================================
  * BASIC OUTPUT FUNCTIONS (Direct output without logging system)
  * ============================================================================ */
@@ -263,6 +320,15 @@ void meow_vga_init(void);
  */
 void meow_vga_clear(void);
 
+/**
+ * meow_vga_flush - Copy changed parts of the shadow buffer to the screen
+ * 
+ * Console output is drawn into a RAM shadow first and only the dirty
+ * spans of each line are written out. The console functions flush before
+ * returning, so callers rarely need this.
+ */
+void meow_vga_flush(void);
+
 /**
  * meow_vga_set_color - Set VGA text colors
  * @foreground: Foreground color (0-15)
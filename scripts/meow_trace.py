@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+# scripts/meow_trace.py - Decode MeowKernel binary trace events
+#
+# meow_trace_dump() writes "MEOWTRACE" lines to the serial port. This
+# script picks them out of a capture (e.g. build/x86/serial.log), looks
+# each event's format string up in the kernel ELF's .meow_trace_fmt
+# section and prints the events in time order, or writes them as Chrome
+# trace JSON for chrome://tracing / Perfetto.
+#
+#   scripts/meow_trace.py build/x86/bin/meowkernel.bin build/x86/serial.log
+#   scripts/meow_trace.py --chrome trace.json meowkernel.bin serial.log
+#
+# Copyright (c) 2025 MeowKernel Project
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+TRACE_SECTION = ".meow_trace_fmt"
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+# printf conversions the kernel's meow_printf understands
+CONVERSION = re.compile(r"%(0?)(\d*)(?:ll|l)?([diuxXcs%])")
+
+
+class KernelImage:
+    """The allocated sections of a kernel ELF, addressable by load address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError(f"{path}: not an ELF file")
+
+        is_64 = data[4] == 2
+        endian = "<" if data[5] == 1 else ">"
+        if is_64:
+            shoff, = struct.unpack_from(endian + "Q", data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x3A)
+            header = endian + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x2E)
+            header = endian + "IIIIIIIIII"
+
+        sections = [struct.unpack_from(header, data, shoff + i * shentsize)
+                    for i in range(shnum)]
+        names = sections[shstrndx]
+        names_offset = names[4]
+
+        self.sections = []
+        self.trace_section = None
+        for name, sh_type, flags, addr, offset, size, *_ in sections:
+            end = data.index(b"\0", names_offset + name)
+            section_name = data[names_offset + name:end].decode()
+            if not flags & SHF_ALLOC or sh_type == SHT_NOBITS or size == 0:
+                continue
+            entry = (addr, size, data[offset:offset + size])
+            self.sections.append(entry)
+            if section_name == TRACE_SECTION:
+                self.trace_section = entry
+
+        if self.trace_section is None:
+            raise ValueError(f"{path}: no {TRACE_SECTION} section (built with TRACE=0?)")
+
+    def string_at(self, address):
+        for addr, size, contents in self.sections:
+            if addr <= address < addr + size:
+                start = address - addr
+                end = contents.find(b"\0", start)
+                return contents[start:end if end >= 0 else size].decode(errors="replace")
+        return None
+
+    def format_at(self, address):
+        addr, size, _ = self.trace_section
+        if not addr <= address < addr + size:
+            return None
+        return self.string_at(address)
+
+
+def render(image, fmt, args):
+    """Expand a kernel format string with raw 32-bit arguments."""
+    args = list(args)
+
+    def expand(match):
+        zero, width, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        value = args.pop(0) if args else 0
+        if conversion in "di":
+            text = str(value - (1 << 32) if value & 0x80000000 else value)
+        elif conversion == "u":
+            text = str(value)
+        elif conversion == "x":
+            text = f"{value:x}"
+        elif conversion == "X":
+            text = f"{value:X}"
+        elif conversion == "c":
+            text = chr(value & 0xFF)
+        else:
+            text = image.string_at(value)
+            if text is None:
+                text = f"<0x{value:08x}>"
+        return text.rjust(int(width), "0" if zero else " ") if width else text
+
+    return CONVERSION.sub(expand, fmt)
+
+
+def parse_dump(lines):
+    """Yield (khz, events, lost) for every dump found in the capture."""
+    khz = 0
+    events = None
+    for line in lines:
+        start = line.find("MEOWTRACE ")
+        if start < 0:
+            continue
+        fields = line[start:].split()
+        if fields[1] == "begin":
+            values = dict(field.split("=", 1) for field in fields[2:])
+            khz = int(values.get("khz", "0"))
+            events = []
+        elif fields[1] == "end":
+            if events is not None:
+                lost = int(dict(field.split("=", 1) for field in fields[2:]).get("lost", "0"))
+                yield khz, events, lost
+            events = None
+        elif events is not None and len(fields) == 8:
+            cpu = int(fields[1])
+            fmt, timestamp = int(fields[2], 16), int(fields[3], 16)
+            args = [int(field, 16) for field in fields[4:8]]
+            events.append((timestamp, cpu, fmt, args))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode MeowKernel MEOWTRACE dumps")
+    parser.add_argument("kernel", help="kernel ELF the trace was taken with")
+    parser.add_argument("log", nargs="?", help="serial capture (default: stdin)")
+    parser.add_argument("--chrome", metavar="FILE", help="write Chrome trace JSON to FILE")
+    parser.add_argument("--all", action="store_true", help="decode every dump, not just the last")
+    options = parser.parse_args()
+
+    image = KernelImage(options.kernel)
+    if options.log:
+        with open(options.log, errors="replace") as f:
+            dumps = list(parse_dump(f))
+    else:
+        dumps = list(parse_dump(sys.stdin))
+    if not dumps:
+        sys.exit("no complete MEOWTRACE dump found")
+    if not options.all:
+        dumps = dumps[-1:]
+
+    chrome_events = []
+    for khz, events, lost in dumps:
+        events.sort()
+        first = events[0][0] if events else 0
+        for timestamp, cpu, fmt_address, args in events:
+            # kHz ticks per millisecond; fall back to raw ticks if unknown
+            micros = (timestamp - first) * 1000 / khz if khz else float(timestamp - first)
+            fmt = image.format_at(fmt_address)
+            text = render(image, fmt, args) if fmt else f"<unknown format 0x{fmt_address:08x}>"
+            if options.chrome:
+                chrome_events.append({"name": text, "cat": text.split(":", 1)[0],
+                                      "ph": "i", "s": "t", "ts": micros,
+                                      "pid": 0, "tid": cpu})
+            else:
+                print(f"[{micros / 1e6:12.6f}] cpu{cpu} {text}")
+        if lost and not options.chrome:
+            print(f"({lost} events were being written during the dump)")
+
+    if options.chrome:
+        with open(options.chrome, "w") as f:
+            json.dump({"traceEvents": chrome_events, "displayTimeUnit": "ns"}, f)
+
+
+if __name__ == "__main__":
+    main()